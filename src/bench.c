@@ -0,0 +1,667 @@
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "s21_matrix.h"
+
+/*
+ * Замеры всех операций s21_* на квадратных матрицах n x n, n от 1 до --max.
+ * Для каждой пары (операция, n) число повторов подбирается так, чтобы замер
+ * длился не меньше --time секунд; из BENCH_REPS замеров берётся лучший.
+ * Байты - сколько malloc/calloc/realloc/aligned_alloc выделили за одну операцию
+ * (на Linux вызовы перехватываются через ld --wrap, см. Makefile).
+ *
+ *   ./bench.out [--ops a,b] [--max N] [--time S] [--format table|csv|json]
+ *               [--save FILE] [--baseline FILE] [--threshold PCT]
+ *
+ * --save пишет CSV, который затем подаётся в --baseline: строки, ставшие медленнее
+ * базовых больше чем на PCT процентов, помечаются, а код возврата становится 1
+ * (2 - ошибка аргументов или файлов).
+ */
+
+#define BENCH_REPS      3
+#define BENCH_MAX_SIZES 32
+#define BENCH_BATCH     1024
+
+typedef struct bench_ctx {
+    int         n;
+    matrix_t    A;
+    matrix_t    B;
+    matrix_t    C;
+    matrix_t    R;
+    s21_lu_t    lu;
+    s21_batch_t batch_a;
+    s21_batch_t batch_b;
+    s21_batch_t batch_r;
+    double      *det;
+    s21_mat4_t  fixed[3];
+    s21_arena_t *arena;
+    s21_pool_t  *pool;
+    s21_sparse_t sparse;
+    double      *vec;
+    int         cached;
+} bench_ctx_t;
+
+typedef int (*bench_fn)(bench_ctx_t *c);
+
+// flops - степень n и коэффициент: flops(n) = scale * n^power; для пакетов - на одну матрицу.
+typedef struct bench_op {
+    const char *name;
+    bench_fn   run;
+    int        min_n;
+    int        max_n;
+    int        power;
+    double     scale;
+    int        setup;
+} bench_op_t;
+
+// Что готовить перед замером помимо A, B, C.
+#define SETUP_NONE  0
+#define SETUP_LU    1
+#define SETUP_BATCH 2
+#define SETUP_FIXED 3
+#define SETUP_ALLOC 4
+#define SETUP_SPARSE 5
+#define SETUP_CACHE 6
+
+// Доля ненулевых элементов разреженной матрицы - 1 / BENCH_SPARSE.
+#define BENCH_SPARSE 100
+
+typedef struct bench_result {
+    const char *op;
+    int        n;
+    long       iters;
+    double     ns;
+    double     gflops;
+    double     bytes;
+    double     base_ns;
+    int        regressed;
+} bench_result_t;
+
+typedef struct bench_options {
+    const char *ops;
+    const char *format;
+    const char *save;
+    const char *baseline;
+    int        max_n;
+    double     min_time;
+    double     threshold;
+} bench_options_t;
+
+static size_t bench_allocated;
+
+static int run_create(bench_ctx_t *c) {
+    int ret = s21_create_matrix(c->n, c->n, &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+// Прежняя схема хранения - массив указателей и отдельный calloc на каждую строку: база для create_matrix.
+static int legacy_create_matrix(int rows, int columns, matrix_t *result);
+static void legacy_remove_matrix(matrix_t *A);
+
+static int run_create_legacy(bench_ctx_t *c) {
+    int ret = legacy_create_matrix(c->n, c->n, &c->R);
+    legacy_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_create_in(bench_ctx_t *c) {
+    int ret = s21_create_matrix_in(c->arena, c->n, c->n, &c->R);
+    s21_arena_reset(c->arena);
+    return ret;
+}
+
+static int run_create_pooled(bench_ctx_t *c) {
+    int ret = s21_create_matrix_pooled(c->pool, c->n, c->n, &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_eq(bench_ctx_t *c) {
+    return s21_eq_matrix(&c->A, &c->C) == 1 ? 0 : 2;
+}
+
+// Операции с результатом: результат сразу удаляется, его выделение входит в замер.
+#define BENCH_RESULT_OP(name, call) \
+    static int run_##name(bench_ctx_t *c) { \
+        int ret = call; \
+        s21_remove_matrix(&c->R); \
+        return ret; \
+    }
+
+BENCH_RESULT_OP(sum, s21_sum_matrix(&c->A, &c->B, &c->R))
+BENCH_RESULT_OP(sub, s21_sub_matrix(&c->A, &c->B, &c->R))
+BENCH_RESULT_OP(mult_number, s21_mult_number(&c->A, 1.5, &c->R))
+BENCH_RESULT_OP(mult_matrix, s21_mult_matrix(&c->A, &c->B, &c->R))
+BENCH_RESULT_OP(transpose, s21_transpose(&c->A, &c->R))
+BENCH_RESULT_OP(calc_complements, s21_calc_complements(&c->A, &c->R))
+BENCH_RESULT_OP(inverse, s21_inverse_matrix(&c->A, &c->R))
+BENCH_RESULT_OP(lu_solve, s21_lu_solve(&c->lu, &c->B, &c->R))
+BENCH_RESULT_OP(lu_inverse, s21_lu_inverse(&c->lu, &c->R))
+
+static int run_determinant(bench_ctx_t *c) {
+    double det;
+    return s21_determinant(&c->A, &det);
+}
+
+static int run_sum_inplace(bench_ctx_t *c) {
+    return s21_sum_matrix_inplace(&c->C, &c->B);
+}
+
+static int run_sub_inplace(bench_ctx_t *c) {
+    return s21_sub_matrix_inplace(&c->C, &c->B);
+}
+
+static int run_mult_number_inplace(bench_ctx_t *c) {
+    return s21_mult_number_inplace(&c->C, 1.0);
+}
+
+// Штрассен включается только на время замера, остальные операции идут обычным путём.
+static int run_mult_strassen(bench_ctx_t *c) {
+    s21_set_mult_policy(S21_MULT_STRASSEN, 0);
+    int ret = s21_mult_matrix(&c->A, &c->B, &c->R);
+    s21_set_mult_policy(S21_MULT_CLASSIC, 0);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+// Кэш включён только на время замера (SETUP_CACHE): после первого вызова обращение
+// к тому же A - хеширование и копия результата.
+static int run_inverse_cached(bench_ctx_t *c) {
+    int ret = s21_inverse_matrix(&c->A, &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_axpy(bench_ctx_t *c) {
+    return s21_axpy(0.5, &c->B, &c->C);
+}
+
+// (A + B) * 1.5 - C одним проходом; выражение строится заново в каждой итерации.
+static int run_eval(bench_ctx_t *c) {
+    s21_expr_t e;
+    s21_expr_init(&e);
+    int sum = s21_expr_sum(&e, s21_expr_matrix(&e, &c->A), s21_expr_matrix(&e, &c->B));
+    int ret = s21_eval(&e, s21_expr_sub(&e, s21_expr_scale(&e, sum, 1.5), s21_expr_matrix(&e, &c->C)), &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_gemm(bench_ctx_t *c) {
+    return s21_gemm(1, &c->A, &c->B, 0, &c->C);
+}
+
+static int run_transpose_inplace(bench_ctx_t *c) {
+    return s21_transpose_inplace(&c->C);
+}
+
+static int run_transpose_lazy(bench_ctx_t *c) {
+    return s21_transpose_lazy(&c->A, &c->R);
+}
+
+static int run_view(bench_ctx_t *c) {
+    matrix_view_t view;
+    int ret = s21_submatrix_view(&c->A, 0, 0, c->n, c->n, &view);
+    if (ret == 0)
+        ret = s21_view_to_matrix(&view, &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_lu_factor(bench_ctx_t *c) {
+    s21_lu_t lu;
+    int ret = s21_lu_factor(&c->A, &lu);
+    s21_lu_free(&lu);
+    return ret;
+}
+
+static int run_batch_mult(bench_ctx_t *c) {
+    int ret = s21_batch_mult(&c->batch_a, &c->batch_b, &c->batch_r);
+    s21_batch_remove(&c->batch_r);
+    return ret;
+}
+
+static int run_batch_det(bench_ctx_t *c) {
+    return s21_batch_det(&c->batch_a, c->det);
+}
+
+static int run_batch_inverse(bench_ctx_t *c) {
+    int ret = s21_batch_inverse(&c->batch_a, &c->batch_r);
+    s21_batch_remove(&c->batch_r);
+    return ret;
+}
+
+static int run_sparse_mult_vector(bench_ctx_t *c) {
+    return s21_sparse_mult_vector(&c->sparse, c->vec, c->vec + c->n);
+}
+
+static int run_sparse_mult_matrix(bench_ctx_t *c) {
+    int ret = s21_sparse_mult_matrix(&c->sparse, &c->B, &c->R);
+    s21_remove_matrix(&c->R);
+    return ret;
+}
+
+static int run_sparse_sum(bench_ctx_t *c) {
+    s21_sparse_t r;
+    int ret = s21_sparse_sum(&c->sparse, &c->sparse, &r);
+    s21_sparse_remove(&r);
+    return ret;
+}
+
+// Фиксированные типы выбираются по n; результат копится в fixed[2], чтобы вызов не выбросился.
+#define BENCH_FIXED(c, call2, call3, call4) \
+    ((c)->n == 2 ? call2 : (c)->n == 3 ? call3 : call4)
+#define FIXED_ARG(c, N, i) ((s21_mat##N##_t *)&(c)->fixed[i])
+
+static int run_fixed_det(bench_ctx_t *c) {
+    c->fixed[2].m[0][0] += BENCH_FIXED(c, s21_mat2_det(FIXED_ARG(c, 2, 0)), s21_mat3_det(FIXED_ARG(c, 3, 0)),
+                                       s21_mat4_det(FIXED_ARG(c, 4, 0)));
+    return 0;
+}
+
+static int run_fixed_inverse(bench_ctx_t *c) {
+    return BENCH_FIXED(c, s21_mat2_inverse(FIXED_ARG(c, 2, 0), FIXED_ARG(c, 2, 2)),
+                       s21_mat3_inverse(FIXED_ARG(c, 3, 0), FIXED_ARG(c, 3, 2)),
+                       s21_mat4_inverse(FIXED_ARG(c, 4, 0), FIXED_ARG(c, 4, 2)));
+}
+
+static int run_fixed_mult(bench_ctx_t *c) {
+    if (c->n == 2)
+        s21_mat2_mult(FIXED_ARG(c, 2, 0), FIXED_ARG(c, 2, 1), FIXED_ARG(c, 2, 2));
+    else if (c->n == 3)
+        s21_mat3_mult(FIXED_ARG(c, 3, 0), FIXED_ARG(c, 3, 1), FIXED_ARG(c, 3, 2));
+    else
+        s21_mat4_mult(FIXED_ARG(c, 4, 0), FIXED_ARG(c, 4, 1), FIXED_ARG(c, 4, 2));
+    return 0;
+}
+
+static const bench_op_t bench_ops[] = {
+    {"create_matrix",          run_create,              1, 4096, 0, 0, SETUP_NONE},
+    {"create_matrix_legacy",   run_create_legacy,       1, 4096, 0, 0, SETUP_NONE},
+    {"create_matrix_in",       run_create_in,           1, 4096, 0, 0, SETUP_ALLOC},
+    {"create_matrix_pooled",   run_create_pooled,       1, 4096, 0, 0, SETUP_ALLOC},
+    {"eq_matrix",              run_eq,                  1, 4096, 2, 1, SETUP_NONE},
+    {"sum_matrix",             run_sum,                 1, 4096, 2, 1, SETUP_NONE},
+    {"sub_matrix",             run_sub,                 1, 4096, 2, 1, SETUP_NONE},
+    {"mult_number",            run_mult_number,         1, 4096, 2, 1, SETUP_NONE},
+    {"mult_matrix",            run_mult_matrix,         1, 4096, 3, 2, SETUP_NONE},
+    {"mult_matrix_strassen",   run_mult_strassen,       1, 4096, 3, 2, SETUP_NONE},
+    {"transpose",              run_transpose,           1, 4096, 0, 0, SETUP_NONE},
+    {"calc_complements",       run_calc_complements,    1, 1024, 3, 2, SETUP_NONE},
+    {"determinant",            run_determinant,         1, 2048, 3, 2.0 / 3, SETUP_NONE},
+    {"inverse_matrix",         run_inverse,             1, 2048, 3, 2, SETUP_NONE},
+    {"inverse_matrix_cached",  run_inverse_cached,      1, 2048, 3, 2, SETUP_CACHE},
+    {"sum_matrix_inplace",     run_sum_inplace,         1, 4096, 2, 1, SETUP_NONE},
+    {"sub_matrix_inplace",     run_sub_inplace,         1, 4096, 2, 1, SETUP_NONE},
+    {"mult_number_inplace",    run_mult_number_inplace, 1, 4096, 2, 1, SETUP_NONE},
+    {"axpy",                   run_axpy,                1, 4096, 2, 2, SETUP_NONE},
+    {"gemm",                   run_gemm,                1, 4096, 3, 2, SETUP_NONE},
+    {"eval",                   run_eval,                1, 4096, 2, 3, SETUP_NONE},
+    {"transpose_inplace",      run_transpose_inplace,   1, 4096, 0, 0, SETUP_NONE},
+    {"transpose_lazy",         run_transpose_lazy,      1, 4096, 0, 0, SETUP_NONE},
+    {"submatrix_view",         run_view,                1, 4096, 0, 0, SETUP_NONE},
+    {"lu_factor",              run_lu_factor,           1, 2048, 3, 2.0 / 3, SETUP_NONE},
+    {"lu_solve",               run_lu_solve,            1, 2048, 3, 2, SETUP_LU},
+    {"lu_inverse",             run_lu_inverse,          1, 2048, 3, 2, SETUP_LU},
+    {"batch_mult",             run_batch_mult,          1, S21_BATCH_MAX, 3, 2, SETUP_BATCH},
+    {"batch_det",              run_batch_det,           1, S21_BATCH_MAX, 3, 2.0 / 3, SETUP_BATCH},
+    {"batch_inverse",          run_batch_inverse,       1, S21_BATCH_MAX, 3, 2, SETUP_BATCH},
+    {"sparse_mult_vector",     run_sparse_mult_vector,  1, 4096, 2, 2.0 / BENCH_SPARSE, SETUP_SPARSE},
+    {"sparse_mult_matrix",     run_sparse_mult_matrix,  1, 4096, 3, 2.0 / BENCH_SPARSE, SETUP_SPARSE},
+    {"sparse_sum",             run_sparse_sum,          1, 4096, 2, 1.0 / BENCH_SPARSE, SETUP_SPARSE},
+    {"fixed_det",              run_fixed_det,           2, 4, 3, 2.0 / 3, SETUP_FIXED},
+    {"fixed_inverse",          run_fixed_inverse,       2, 4, 3, 2, SETUP_FIXED},
+    {"fixed_mult",             run_fixed_mult,          2, 4, 3, 2, SETUP_FIXED},
+};
+
+static int parse_options(int argc, char **argv, bench_options_t *opt);
+static int selected(const char *list, const char *name);
+static int bench_sizes(const bench_op_t *op, int max_n, int *sizes);
+static int bench_prepare(const bench_op_t *op, int n, bench_ctx_t *c);
+static void bench_release(bench_ctx_t *c);
+static void fill_matrix(matrix_t *A, unsigned seed);
+static int bench_measure(const bench_op_t *op, bench_ctx_t *c, double min_time, bench_result_t *r);
+static int load_baseline(const char *path, bench_result_t *results, int count);
+static int write_results(FILE *out, const char *format, const bench_result_t *results, int count);
+static double now_seconds(void);
+
+int main(int argc, char **argv) {
+    bench_options_t opt = {NULL, "table", NULL, NULL, 1024, 0.05, 10};
+    bench_result_t *results = NULL;
+    int ops = sizeof(bench_ops) / sizeof(bench_ops[0]);
+    int count = 0, ret = parse_options(argc, argv, &opt);
+
+    if (ret == 0)
+        results = (bench_result_t *)calloc(ops * BENCH_MAX_SIZES, sizeof(bench_result_t));
+    if (results == NULL)
+        ret = 2;
+    for (int i = 0; i < ops && ret == 0; i++) {
+        int sizes[BENCH_MAX_SIZES];
+        int n_sizes = selected(opt.ops, bench_ops[i].name) ? bench_sizes(&bench_ops[i], opt.max_n, sizes) : 0;
+        for (int j = 0; j < n_sizes; j++) {
+            bench_ctx_t c;
+            if (bench_prepare(&bench_ops[i], sizes[j], &c) == 0 &&
+                bench_measure(&bench_ops[i], &c, opt.min_time, &results[count]) == 0) {
+                count++;
+            } else {
+                fprintf(stderr, "bench: %s n=%d failed\n", bench_ops[i].name, sizes[j]);
+            }
+            bench_release(&c);
+        }
+    }
+
+    if (ret == 0 && opt.baseline != NULL && load_baseline(opt.baseline, results, count) != 0) {
+        fprintf(stderr, "bench: cannot read baseline %s\n", opt.baseline);
+        ret = 2;
+    }
+    if (ret == 0) {
+        for (int i = 0; i < count; i++)
+            results[i].regressed = results[i].base_ns > 0 &&
+                                   results[i].ns > results[i].base_ns * (1 + opt.threshold / 100);
+        write_results(stdout, opt.format, results, count);
+        if (opt.save != NULL) {
+            FILE *f = fopen(opt.save, "w");
+            if (f == NULL || write_results(f, "csv", results, count) != 0)
+                ret = 2;
+            if (f != NULL)
+                fclose(f);
+        }
+        for (int i = 0; i < count && ret == 0; i++)
+            if (results[i].regressed)
+                ret = 1;
+    }
+    free(results);
+
+    return ret;
+}
+
+static int parse_options(int argc, char **argv, bench_options_t *opt) {
+    int ret = 0;
+
+    for (int i = 1; i < argc && ret == 0; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (value == NULL)
+            ret = 2;
+        else if (strcmp(argv[i], "--ops") == 0)
+            opt->ops = value;
+        else if (strcmp(argv[i], "--max") == 0)
+            opt->max_n = atoi(value);
+        else if (strcmp(argv[i], "--time") == 0)
+            opt->min_time = atof(value);
+        else if (strcmp(argv[i], "--format") == 0)
+            opt->format = value;
+        else if (strcmp(argv[i], "--save") == 0)
+            opt->save = value;
+        else if (strcmp(argv[i], "--baseline") == 0)
+            opt->baseline = value;
+        else if (strcmp(argv[i], "--threshold") == 0)
+            opt->threshold = atof(value);
+        else
+            ret = 2;
+        i++;
+    }
+    if (ret == 0 && strcmp(opt->format, "table") && strcmp(opt->format, "csv") && strcmp(opt->format, "json"))
+        ret = 2;
+    if (ret != 0)
+        fprintf(stderr, "usage: %s [--ops a,b] [--max N] [--time S] [--format table|csv|json] "
+                        "[--save FILE] [--baseline FILE] [--threshold PCT]\n", argv[0]);
+
+    return ret;
+}
+
+// Список через запятую; NULL - все операции.
+static int selected(const char *list, const char *name) {
+    int found = list == NULL;
+    size_t len = strlen(name);
+
+    for (const char *p = list; p != NULL && !found; p = strchr(p, ',') ? strchr(p, ',') + 1 : NULL)
+        found = strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0');
+
+    return found;
+}
+
+// Степени двойки и малые размеры, где работают явные формулы и ядра пакетов.
+static int bench_sizes(const bench_op_t *op, int max_n, int *sizes) {
+    int count = 0;
+
+    for (int n = op->min_n; n <= op->max_n && n <= max_n && count < BENCH_MAX_SIZES;
+         n = n < 4 || op->max_n <= S21_BATCH_MAX ? n + 1 : n * 2)
+        sizes[count++] = n;
+
+    return count;
+}
+
+static int bench_prepare(const bench_op_t *op, int n, bench_ctx_t *c) {
+    int ret = 0;
+    memset(c, 0, sizeof(*c));
+    c->n = n;
+
+    if (s21_create_matrix(n, n, &c->A) || s21_create_matrix(n, n, &c->B) || s21_create_matrix(n, n, &c->C)) {
+        ret = 2;
+    } else {
+        fill_matrix(&c->A, 1);
+        fill_matrix(&c->B, 2);
+        memcpy(c->C.matrix[0], c->A.matrix[0], sizeof(double) * n * n);
+    }
+    if (ret == 0 && op->setup == SETUP_LU) {
+        ret = s21_lu_factor(&c->A, &c->lu);
+    } else if (ret == 0 && op->setup == SETUP_BATCH) {
+        ret = s21_batch_create(BENCH_BATCH, n, n, &c->batch_a) ||
+              s21_batch_create(BENCH_BATCH, n, n, &c->batch_b) ||
+              (c->det = (double *)malloc(sizeof(double) * BENCH_BATCH)) == NULL;
+        for (int k = 0; k < BENCH_BATCH && ret == 0; k++)
+            ret = s21_batch_set(&c->batch_a, k, &c->A) || s21_batch_set(&c->batch_b, k, &c->B);
+    } else if (ret == 0 && op->setup == SETUP_FIXED) {
+        for (int y = 0; y < n; y++)
+            for (int x = 0; x < n; x++) {
+                ((double *)&c->fixed[0])[y * n + x] = c->A.matrix[y][x];
+                ((double *)&c->fixed[1])[y * n + x] = c->B.matrix[y][x];
+            }
+    } else if (ret == 0 && op->setup == SETUP_SPARSE) {
+        // Разреженная копия A: остаётся примерно каждый BENCH_SPARSE-й элемент и диагональ.
+        for (int y = 0; y < n; y++)
+            for (int x = 0; x < n; x++)
+                if (y != x && (y * 31 + x * 17) % BENCH_SPARSE != 0)
+                    c->C.matrix[y][x] = 0;
+        ret = s21_sparse_from_matrix(&c->C, S21_CSR, &c->sparse) ||
+              (c->vec = (double *)calloc(2 * (size_t)n, sizeof(double))) == NULL;
+    } else if (ret == 0 && op->setup == SETUP_ALLOC) {
+        c->arena = s21_arena_create(0);
+        c->pool = s21_pool_create();
+        ret = c->arena == NULL || c->pool == NULL;
+    } else if (ret == 0 && op->setup == SETUP_CACHE) {
+        s21_set_cache_limit((size_t)1 << 30);
+        c->cached = 1;
+    }
+
+    return ret;
+}
+
+static void bench_release(bench_ctx_t *c) {
+    s21_remove_matrix(&c->A);
+    s21_remove_matrix(&c->B);
+    s21_remove_matrix(&c->C);
+    s21_lu_free(&c->lu);
+    s21_batch_remove(&c->batch_a);
+    s21_batch_remove(&c->batch_b);
+    free(c->det);
+    s21_arena_destroy(c->arena);
+    s21_pool_destroy(c->pool);
+    s21_sparse_remove(&c->sparse);
+    free(c->vec);
+    // Лимит 0 выключает кэш и освобождает записи, остальные операции замеряются без него.
+    if (c->cached)
+        s21_set_cache_limit(0);
+}
+
+// Случайные элементы из [-1, 1] и n на диагонали: матрица хорошо обусловлена и обратима.
+static void fill_matrix(matrix_t *A, unsigned seed) {
+    unsigned state = seed * 2654435761u + 1;
+
+    for (int y = 0; y < A->rows; y++)
+        for (int x = 0; x < A->columns; x++) {
+            state = state * 1103515245u + 12345u;
+            A->matrix[y][x] = (double)((state >> 8) % 2001) / 1000.0 - 1.0 + (y == x ? A->rows : 0);
+        }
+}
+
+static int bench_measure(const bench_op_t *op, bench_ctx_t *c, double min_time, bench_result_t *r) {
+    int ret = op->run(c);
+    long iters = 1;
+    double best = 0, elapsed = 0;
+    size_t bytes = 0;
+
+    // Первый вызов прогревает кэши и пулы; затем число повторов удваивается до min_time.
+    while (ret == 0 && elapsed < min_time) {
+        size_t before = bench_allocated;
+        double start = now_seconds();
+        for (long i = 0; i < iters && ret == 0; i++)
+            ret = op->run(c);
+        elapsed = now_seconds() - start;
+        bytes = bench_allocated - before;
+        if (elapsed > 0 && elapsed < min_time && min_time / elapsed < 2)
+            iters = (long)(iters * min_time / elapsed * 1.1) + 1;
+        else if (elapsed < min_time)
+            iters *= 2;
+    }
+    best = elapsed;
+    for (int rep = 1; rep < BENCH_REPS && ret == 0; rep++) {
+        double start = now_seconds();
+        for (long i = 0; i < iters && ret == 0; i++)
+            ret = op->run(c);
+        elapsed = now_seconds() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+
+    if (ret == 0) {
+        double flops = op->scale * pow(c->n, op->power) * (op->setup == SETUP_BATCH ? BENCH_BATCH : 1);
+        r->op = op->name;
+        r->n = c->n;
+        r->iters = iters;
+        r->ns = best * 1e9 / iters;
+        r->gflops = flops / r->ns;
+        r->bytes = (double)bytes / iters;
+    }
+
+    return ret;
+}
+
+// Базовый CSV - вывод --save: op,n,iters,ns_per_op,gflops,bytes_per_op.
+static int load_baseline(const char *path, bench_result_t *results, int count) {
+    FILE *f = fopen(path, "r");
+    char line[256], name[128];
+    int n;
+    double ns;
+
+    while (f != NULL && fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%127[^,],%d,%*d,%lf", name, &n, &ns) == 3) {
+            for (int i = 0; i < count; i++)
+                if (results[i].n == n && strcmp(results[i].op, name) == 0)
+                    results[i].base_ns = ns;
+        }
+    }
+    if (f != NULL)
+        fclose(f);
+
+    return f == NULL;
+}
+
+static int write_results(FILE *out, const char *format, const bench_result_t *results, int count) {
+    int json = strcmp(format, "json") == 0, csv = strcmp(format, "csv") == 0;
+
+    if (csv)
+        fprintf(out, "op,n,iters,ns_per_op,gflops,bytes_per_op,baseline_ns,change_pct\n");
+    else if (json)
+        fprintf(out, "[\n");
+    else
+        fprintf(out, "%-22s %6s %10s %14s %9s %14s %9s\n", "op", "n", "iters", "ns/op", "GFLOP/s", "bytes/op",
+                "change");
+
+    for (int i = 0; i < count; i++) {
+        const bench_result_t *r = &results[i];
+        double change = r->base_ns > 0 ? (r->ns / r->base_ns - 1) * 100 : 0;
+        if (csv)
+            fprintf(out, "%s,%d,%ld,%.2f,%.4f,%.0f,%.2f,%.2f\n", r->op, r->n, r->iters, r->ns, r->gflops,
+                    r->bytes, r->base_ns, change);
+        else if (json)
+            fprintf(out, "  {\"op\": \"%s\", \"n\": %d, \"iters\": %ld, \"ns_per_op\": %.2f, "
+                         "\"gflops\": %.4f, \"bytes_per_op\": %.0f, \"baseline_ns\": %.2f, "
+                         "\"change_pct\": %.2f, \"regressed\": %s}%s\n",
+                    r->op, r->n, r->iters, r->ns, r->gflops, r->bytes, r->base_ns, change,
+                    r->regressed ? "true" : "false", i + 1 < count ? "," : "");
+        else if (r->base_ns > 0)
+            fprintf(out, "%-22s %6d %10ld %14.1f %9.3f %14.0f %+8.1f%%%s\n", r->op, r->n, r->iters, r->ns,
+                    r->gflops, r->bytes, change, r->regressed ? " REGRESSION" : "");
+        else
+            fprintf(out, "%-22s %6d %10ld %14.1f %9.3f %14.0f %9s\n", r->op, r->n, r->iters, r->ns, r->gflops,
+                    r->bytes, "-");
+    }
+    if (json)
+        fprintf(out, "]\n");
+
+    return ferror(out);
+}
+
+static int legacy_create_matrix(int rows, int columns, matrix_t *result) {
+    int ret = 0;
+    result->rows = rows;
+    result->columns = columns;
+    result->matrix = (double **)calloc(rows, sizeof(double *));
+
+    if (result->matrix == NULL) {
+        ret = 2;
+    } else {
+        for (int i = 0; i < rows && !ret; i++) {
+            result->matrix[i] = (double *)calloc(columns, sizeof(double));
+            if (result->matrix[i] == NULL)
+                ret = 2;
+        }
+    }
+
+    return ret;
+}
+
+// calloc обнулил ещё не выделенные строки, free(NULL) допустим.
+static void legacy_remove_matrix(matrix_t *A) {
+    for (int i = 0; A->matrix != NULL && i < A->rows; i++)
+        free(A->matrix[i]);
+    free(A->matrix);
+    A->matrix = NULL;
+    A->rows = 0;
+    A->columns = 0;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#ifdef BENCH_WRAP_ALLOC
+// Перехват выделений памяти библиотекой: -Wl,--wrap=malloc и т.д.
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t align, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    __atomic_fetch_add(&bench_allocated, size, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&bench_allocated, count * size, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&bench_allocated, size, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+void *__wrap_aligned_alloc(size_t align, size_t size) {
+    __atomic_fetch_add(&bench_allocated, size, __ATOMIC_RELAXED);
+    return __real_aligned_alloc(align, size);
+}
+#endif
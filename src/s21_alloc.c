@@ -0,0 +1,389 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <sys/mman.h>
+#include "s21_matrix.h"
+
+#define BLOCK_HEAP  0
+#define BLOCK_ARENA 1
+#define BLOCK_POOL  2
+#define BLOCK_MAPPED 3
+
+#define ARENA_DEFAULT   (1 << 20)
+#define POOL_CLASSES    48
+#define POOL_MIN_CLASS  7
+#define POOL_MAX_CACHED 16
+// Временные буферы больше этого размера не кэшируются, а берутся из кучи.
+#define SCRATCH_MAX     (8 << 20)
+
+// Заголовок перед каждым блоком памяти матрицы: кто владелец и куда вернуть блок.
+typedef struct matrix_block {
+    s21_pool_t          *pool;
+    struct matrix_block *next;
+    size_t              capacity;
+    int                 owner;
+    int                 size_class;
+    void                *map;
+    size_t              map_size;
+} matrix_block_t;
+
+typedef struct arena_chunk {
+    struct arena_chunk *next;
+    size_t             size;
+    size_t             used;
+} arena_chunk_t;
+
+struct s21_arena {
+    arena_chunk_t *first;
+    arena_chunk_t *current;
+    size_t        capacity;
+};
+
+struct s21_pool {
+    matrix_block_t *free_list[POOL_CLASSES];
+    int            cached[POOL_CLASSES];
+    size_t         live;
+    int            closing;
+};
+
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+
+static void *arena_alloc(s21_arena_t *arena, size_t bytes);
+static void *pool_alloc(s21_pool_t *pool, size_t bytes);
+static void pool_release(matrix_block_t *block);
+static arena_chunk_t *arena_chunk_new(size_t size);
+static s21_pool_t *scratch_pool(void);
+static void scratch_key_create(void);
+static void scratch_pool_destroy(void *pool);
+
+s21_arena_t *s21_arena_create(size_t capacity) {
+    s21_arena_t *arena = (s21_arena_t *)malloc(sizeof(s21_arena_t));
+
+    if (arena != NULL) {
+        arena->capacity = capacity > 0 ? capacity : ARENA_DEFAULT;
+        arena->first = arena_chunk_new(arena->capacity);
+        arena->current = arena->first;
+        if (arena->first == NULL) {
+            free(arena);
+            arena = NULL;
+        }
+    }
+
+    return arena;
+}
+
+// Все матрицы арены становятся недействительными, память остаётся за ареной.
+void s21_arena_reset(s21_arena_t *arena) {
+    if (arena != NULL) {
+        for (arena_chunk_t *c = arena->first; c != NULL; c = c->next)
+            c->used = 0;
+        arena->current = arena->first;
+    }
+}
+
+void s21_arena_destroy(s21_arena_t *arena) {
+    if (arena != NULL) {
+        arena_chunk_t *c = arena->first;
+        while (c != NULL) {
+            arena_chunk_t *next = c->next;
+            free(c);
+            c = next;
+        }
+        free(arena);
+    }
+}
+
+int s21_create_matrix_in(s21_arena_t *arena, int rows, int columns, matrix_t *result) {
+    int ret = 0;
+    size_t bytes = matrix_bytes(rows, columns);
+    void *mem = NULL;
+
+    if (bytes == 0) {
+        ret = rows < 1 || columns < 1 ? 1 : 2;
+    } else if (arena == NULL || (mem = arena_alloc(arena, bytes)) == NULL) {
+        ret = 2;
+    } else {
+        ((matrix_block_t *)mem)->owner = BLOCK_ARENA;
+        ((matrix_block_t *)mem)->capacity = bytes;
+        matrix_layout(mem, rows, columns, result);
+        memset(result->matrix[0], 0, sizeof(double) * rows * columns);
+        STATS_ALLOC(bytes);
+        STATS_LIVE(1);
+    }
+    if (ret != 0) {
+        result->matrix = NULL;
+        result->rows = 0;
+        result->columns = 0;
+        result->flags = 0;
+    }
+
+    return ret;
+}
+
+s21_pool_t *s21_pool_create(void) {
+    return (s21_pool_t *)calloc(1, sizeof(s21_pool_t));
+}
+
+// Кэш пула освобождается сразу, сам пул - когда будет удалена последняя его матрица.
+void s21_pool_destroy(s21_pool_t *pool) {
+    if (pool != NULL) {
+        for (int i = 0; i < POOL_CLASSES; i++) {
+            while (pool->free_list[i] != NULL) {
+                matrix_block_t *next = pool->free_list[i]->next;
+                free(pool->free_list[i]);
+                pool->free_list[i] = next;
+            }
+            pool->cached[i] = 0;
+        }
+        pool->closing = 1;
+        if (pool->live == 0)
+            free(pool);
+    }
+}
+
+int s21_create_matrix_pooled(s21_pool_t *pool, int rows, int columns, matrix_t *result) {
+    int ret = 0;
+    size_t bytes = matrix_bytes(rows, columns);
+    void *mem = NULL;
+
+    if (bytes == 0) {
+        ret = rows < 1 || columns < 1 ? 1 : 2;
+    } else if (pool == NULL || pool->closing || (mem = pool_alloc(pool, bytes)) == NULL) {
+        ret = 2;
+    } else {
+        matrix_layout(mem, rows, columns, result);
+        memset(result->matrix[0], 0, sizeof(double) * rows * columns);
+        STATS_LIVE(1);
+    }
+    if (ret != 0) {
+        result->matrix = NULL;
+        result->rows = 0;
+        result->columns = 0;
+        result->flags = 0;
+    }
+
+    return ret;
+}
+
+void *matrix_block_alloc(size_t bytes) {
+    matrix_block_t *block = (matrix_block_t *)calloc(1, bytes);
+
+    if (block != NULL) {
+        block->owner = BLOCK_HEAP;
+        block->capacity = bytes;
+        STATS_ALLOC(bytes);
+    }
+
+    return block;
+}
+
+void matrix_block_release(void *mem) {
+    matrix_block_t *block = (matrix_block_t *)((char *)mem - MATRIX_BLOCK_HEADER);
+
+    STATS_FREE(block->capacity);
+    if (block->owner == BLOCK_HEAP) {
+        free(block);
+    } else if (block->owner == BLOCK_POOL) {
+        pool_release(block);
+    } else if (block->owner == BLOCK_MAPPED) {
+        munmap(block->map, block->map_size);
+        free(block);
+    }
+}
+
+// Блок содержит только массив строк, данные остаются в отображении map со смещения offset.
+// Строк хватает и на транспонированную форму, поэтому s21_transpose_inplace не двигает данные.
+int matrix_map(void *map, size_t map_size, size_t offset, int rows, int columns, matrix_t *result) {
+    int ret = 0;
+    size_t bytes = MATRIX_BLOCK_HEADER + (size_t)(rows > columns ? rows : columns) * sizeof(double *);
+    matrix_block_t *block = (matrix_block_t *)calloc(1, bytes);
+
+    if (block == NULL) {
+        ret = 2;
+    } else {
+        block->owner = BLOCK_MAPPED;
+        block->capacity = bytes;
+        block->map = map;
+        block->map_size = map_size;
+        result->matrix = (double **)((char *)block + MATRIX_BLOCK_HEADER);
+        result->rows = rows;
+        result->columns = columns;
+        result->flags = 0;
+        for (int y = 0; y < rows; y++)
+            result->matrix[y] = (double *)((char *)map + offset) + (size_t)y * columns;
+        STATS_ALLOC(bytes);
+        STATS_LIVE(1);
+    }
+
+    return ret;
+}
+
+// Та же память под другую форму: массив строк растёт или сжимается, данные сдвигаются целиком.
+int matrix_reshape(matrix_t *A, int rows, int columns) {
+    int ret = 0;
+    matrix_block_t *block = (matrix_block_t *)((char *)A->matrix - MATRIX_BLOCK_HEADER);
+    size_t count = (size_t)A->rows * A->columns;
+    size_t offset = (uintptr_t)A->matrix[0] - (uintptr_t)block;
+    size_t need = MATRIX_BLOCK_HEADER + (size_t)rows * sizeof(double *) + MATRIX_ALIGN - 1 +
+                  count * sizeof(double);
+
+    if ((size_t)rows * columns != count) {
+        ret = 2;
+    } else if (block->owner == BLOCK_MAPPED) {
+        // Данные отображения остаются на месте, меняются только указатели строк.
+        double *data = A->matrix[0];
+        A->rows = rows;
+        A->columns = columns;
+        for (int y = 0; y < rows; y++)
+            A->matrix[y] = data + (size_t)y * columns;
+    } else if (rows > A->rows && block->owner == BLOCK_HEAP) {
+        matrix_block_t *grown = (matrix_block_t *)realloc(block, matrix_bytes(rows, columns));
+        if (grown == NULL) {
+            ret = 2;
+        } else {
+            STATS_FREE(grown->capacity);
+            block = grown;
+            block->capacity = matrix_bytes(rows, columns);
+            STATS_ALLOC(block->capacity);
+        }
+    } else if (rows > A->rows && (block->owner == BLOCK_ARENA || need > block->capacity)) {
+        ret = 2;
+    }
+
+    if (ret == 0 && block->owner != BLOCK_MAPPED) {
+        uintptr_t data = (uintptr_t)((char *)block + MATRIX_BLOCK_HEADER) + (size_t)rows * sizeof(double *);
+        data = (data + MATRIX_ALIGN - 1) & ~(uintptr_t)(MATRIX_ALIGN - 1);
+        memmove((void *)data, (char *)block + offset, count * sizeof(double));
+        matrix_layout(block, rows, columns, A);
+    }
+
+    return ret;
+}
+
+double *scratch_alloc(size_t count) {
+    size_t bytes = MATRIX_BLOCK_HEADER + count * sizeof(double);
+    matrix_block_t *block = NULL;
+
+    if (count <= (SIZE_MAX - MATRIX_BLOCK_HEADER) / sizeof(double)) {
+        s21_pool_t *pool = bytes <= SCRATCH_MAX ? scratch_pool() : NULL;
+        if (pool != NULL) {
+            block = (matrix_block_t *)pool_alloc(pool, bytes);
+        } else {
+            block = (matrix_block_t *)malloc(bytes);
+            if (block != NULL) {
+                block->owner = BLOCK_HEAP;
+                block->capacity = bytes;
+                STATS_ALLOC(bytes);
+            }
+        }
+    }
+
+    return block != NULL ? (double *)((char *)block + MATRIX_BLOCK_HEADER) : NULL;
+}
+
+void scratch_free(double *buf) {
+    if (buf != NULL)
+        matrix_block_release(buf);
+}
+
+static void *arena_alloc(s21_arena_t *arena, size_t bytes) {
+    void *mem = NULL;
+    arena_chunk_t *c = arena->current;
+
+    while (mem == NULL && c != NULL) {
+        size_t offset = (c->used + MATRIX_ALIGN - 1) & ~(size_t)(MATRIX_ALIGN - 1);
+        if (offset <= c->size && bytes <= c->size - offset) {
+            mem = (char *)c + sizeof(arena_chunk_t) + offset;
+            c->used = offset + bytes;
+            arena->current = c;
+        } else if (c->next == NULL) {
+            c->next = arena_chunk_new(bytes > arena->capacity ? bytes : arena->capacity);
+            c = c->next;
+        } else {
+            c = c->next;
+        }
+    }
+
+    return mem;
+}
+
+static arena_chunk_t *arena_chunk_new(size_t size) {
+    arena_chunk_t *c = NULL;
+
+    if (size <= SIZE_MAX - sizeof(arena_chunk_t) - MATRIX_ALIGN)
+        c = (arena_chunk_t *)aligned_alloc(MATRIX_ALIGN, (sizeof(arena_chunk_t) + size + MATRIX_ALIGN - 1) /
+                                                             MATRIX_ALIGN * MATRIX_ALIGN);
+    if (c != NULL) {
+        c->next = NULL;
+        c->size = size;
+        c->used = 0;
+    }
+
+    return c;
+}
+
+// Классы размеров - степени двойки, блоки одного класса взаимозаменяемы.
+static void *pool_alloc(s21_pool_t *pool, size_t bytes) {
+    int size_class = POOL_MIN_CLASS;
+    while (size_class < POOL_CLASSES && ((size_t)1 << size_class) < bytes)
+        size_class++;
+
+    matrix_block_t *block = NULL;
+    if (size_class < POOL_CLASSES) {
+        block = pool->free_list[size_class];
+        if (block != NULL) {
+            pool->free_list[size_class] = block->next;
+            pool->cached[size_class]--;
+        } else {
+            block = (matrix_block_t *)aligned_alloc(MATRIX_ALIGN, (size_t)1 << size_class);
+        }
+    }
+    if (block != NULL) {
+        block->pool = pool;
+        block->next = NULL;
+        block->capacity = (size_t)1 << size_class;
+        block->owner = BLOCK_POOL;
+        block->size_class = size_class;
+        pool->live++;
+        STATS_ALLOC(block->capacity);
+    }
+
+    return block;
+}
+
+static void pool_release(matrix_block_t *block) {
+    s21_pool_t *pool = block->pool;
+
+    pool->live--;
+    if (pool->closing || pool->cached[block->size_class] >= POOL_MAX_CACHED) {
+        free(block);
+    } else {
+        block->next = pool->free_list[block->size_class];
+        pool->free_list[block->size_class] = block;
+        pool->cached[block->size_class]++;
+    }
+    if (pool->closing && pool->live == 0)
+        free(pool);
+}
+
+// У каждого потока свой пул временных буферов, поэтому блокировки не нужны.
+static s21_pool_t *scratch_pool(void) {
+    pthread_once(&scratch_once, scratch_key_create);
+    s21_pool_t *pool = (s21_pool_t *)pthread_getspecific(scratch_key);
+
+    if (pool == NULL) {
+        pool = s21_pool_create();
+        if (pool != NULL)
+            pthread_setspecific(scratch_key, pool);
+    }
+
+    return pool;
+}
+
+static void scratch_key_create(void) {
+    pthread_key_create(&scratch_key, scratch_pool_destroy);
+}
+
+static void scratch_pool_destroy(void *pool) {
+    s21_pool_destroy((s21_pool_t *)pool);
+}
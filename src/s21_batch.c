@@ -0,0 +1,269 @@
+#include "s21_matrix.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_X86 1
+#else
+#define BATCH_X86 0
+#endif
+
+#define BATCH_LANES S21_BATCH_LANES
+// Матриц на одну задачу пула потоков.
+#ifndef BATCH_TASK
+#define BATCH_TASK 2048
+#endif
+
+#define BATCH_INLINE static inline __attribute__((always_inline))
+#define BATCH_UNROLL _Pragma("GCC unroll 16")
+#define BATCH_CAT2(a, b) a##_##b
+#define BATCH_CAT(a, b) BATCH_CAT2(a, b)
+#define BATCH_NAME(name) BATCH_CAT(name, BATCH_SUFFIX)
+
+// Вектор шире регистра базового ABI нельзя передавать по значению, поэтому макросы.
+#define LANE_LOAD(v, p) memcpy(&(v), (p), sizeof(lane_t))
+#define LANE_STORE(p, v) memcpy((p), &(v), sizeof(lane_t))
+#define LANE_SELECT(m, a, b) ((lane_t)(((lane_mask_t)(a) & (m)) | ((lane_mask_t)(b) & ~(m))))
+#define LANE_ABS(a) LANE_SELECT((a) < 0, -(a), (a))
+#define LANE_ZERO ((lane_t) {0})
+
+typedef struct batch_kernels {
+    void (*mult)(const double *a, const double *b, double *c, int m, int p, int n);
+    void (*det)(const double *a, double *d, int n);
+    int  (*inverse)(const double *a, double *r, int n);
+} batch_kernels_t;
+
+typedef struct batch_job {
+    const batch_kernels_t *k;
+    const s21_batch_t     *A;
+    const s21_batch_t     *B;
+    s21_batch_t           *C;
+    double                *det;
+    int                   op;
+} batch_job_t;
+
+#define BATCH_MULT    0
+#define BATCH_DET     1
+#define BATCH_INVERSE 2
+
+static const batch_kernels_t *batch_kernels(void);
+static int batch_run(batch_job_t *job);
+static int batch_task(void *arg, int task);
+
+int s21_batch_create(int count, int rows, int columns, s21_batch_t *batch) {
+    int ret = 0;
+    batch->data = NULL;
+    batch->count = 0;
+    batch->rows = 0;
+    batch->columns = 0;
+
+    if (count < 1 || rows < 1 || columns < 1 || rows > S21_BATCH_MAX || columns > S21_BATCH_MAX) {
+        ret = 1;
+    } else {
+        // Размер группы кратен 64 байтам, поэтому все группы выровнены так же, как data.
+        size_t groups = ((size_t)count + BATCH_LANES - 1) / BATCH_LANES;
+        size_t bytes = groups * rows * columns * BATCH_LANES * sizeof(double);
+        batch->data = (double *)aligned_alloc(MATRIX_ALIGN, bytes);
+        if (batch->data == NULL) {
+            ret = 2;
+        } else {
+            STATS_ALLOC(bytes);
+            memset(batch->data, 0, bytes);
+            batch->count = count;
+            batch->rows = rows;
+            batch->columns = columns;
+        }
+    }
+
+    return ret;
+}
+
+void s21_batch_remove(s21_batch_t *batch) {
+    STATS_FREE(((size_t)batch->count + BATCH_LANES - 1) / BATCH_LANES * batch->rows * batch->columns *
+               BATCH_LANES * sizeof(double));
+    free(batch->data);
+    batch->data = NULL;
+    batch->count = 0;
+    batch->rows = 0;
+    batch->columns = 0;
+}
+
+int s21_batch_set(s21_batch_t *batch, int index, matrix_t *A) {
+    int ret = 0;
+
+    if (batch->data == NULL || matrix_is_empty(A)) {
+        ret = 1;
+    } else if (index < 0 || index >= batch->count || A->rows != batch->rows || A->columns != batch->columns) {
+        ret = 2;
+    } else {
+        int rs, cs;
+        matrix_strides(A, &rs, &cs);
+        for (int y = 0; y < A->rows; y++)
+            for (int x = 0; x < A->columns; x++)
+                *batch_at(batch, index, y, x) = A->matrix[0][(size_t)y * rs + (size_t)x * cs];
+    }
+
+    return ret;
+}
+
+int s21_batch_get(s21_batch_t *batch, int index, matrix_t *result) {
+    int ret = 0;
+
+    if (batch->data == NULL) {
+        ret = 1;
+    } else if (index < 0 || index >= batch->count) {
+        ret = 2;
+    } else if ((ret = s21_create_matrix(batch->rows, batch->columns, result)) == 0) {
+        for (int y = 0; y < batch->rows; y++)
+            for (int x = 0; x < batch->columns; x++)
+                result->matrix[y][x] = *batch_at(batch, index, y, x);
+    }
+
+    return ret;
+}
+
+int s21_batch_mult(s21_batch_t *A, s21_batch_t *B, s21_batch_t *result) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (A->data == NULL || B->data == NULL) {
+        ret = 1;
+    } else if (A->count != B->count || A->columns != B->rows ||
+               s21_batch_create(A->count, A->rows, B->columns, result) != 0) {
+        ret = 2;
+    } else {
+        batch_job_t job = {batch_kernels(), A, B, result, NULL, BATCH_MULT};
+        ret = batch_run(&job);
+    }
+
+    STATS_END(batch_mult, ret ? 0 : 2.0 * A->count * A->rows * A->columns * B->columns);
+    return ret;
+}
+
+int s21_batch_det(s21_batch_t *A, double *result) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (A->data == NULL) {
+        ret = 1;
+    } else if (A->rows != A->columns) {
+        ret = 2;
+    } else {
+        batch_job_t job = {batch_kernels(), A, NULL, NULL, result, BATCH_DET};
+        ret = batch_run(&job);
+    }
+
+    STATS_END(batch_det, ret ? 0 : 2.0 / 3 * A->count * A->rows * A->rows * A->rows);
+    return ret;
+}
+
+// Если хоть одна матрица вырождена - код 2, и result, как при любой ошибке, не выделен.
+int s21_batch_inverse(s21_batch_t *A, s21_batch_t *result) {
+    STATS_BEGIN();
+    int ret = 0;
+    result->data = NULL;
+    result->count = 0;
+    result->rows = 0;
+    result->columns = 0;
+
+    if (A->data == NULL) {
+        ret = 1;
+    } else if (A->rows != A->columns || s21_batch_create(A->count, A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        batch_job_t job = {batch_kernels(), A, NULL, result, NULL, BATCH_INVERSE};
+        ret = batch_run(&job);
+        if (ret != 0)
+            s21_batch_remove(result);
+    }
+
+    STATS_END(batch_inverse, ret ? 0 : 2.0 * A->count * A->rows * A->rows * A->rows);
+    return ret;
+}
+
+static int batch_run(batch_job_t *job) {
+    int groups = (job->A->count + BATCH_LANES - 1) / BATCH_LANES;
+    int per_task = BATCH_TASK / BATCH_LANES;
+
+    return parallel_for((groups + per_task - 1) / per_task, batch_task, job);
+}
+
+static int batch_task(void *arg, int task) {
+    batch_job_t *job = (batch_job_t *)arg;
+    const s21_batch_t *A = job->A;
+    int first = task * BATCH_TASK;
+    int last = first + BATCH_TASK < A->count ? first + BATCH_TASK : A->count;
+    int ret = 0;
+
+    for (int k = first; k < last; k += BATCH_LANES) {
+        const double *a = batch_at(A, k, 0, 0);
+        if (job->op == BATCH_MULT) {
+            job->k->mult(a, batch_at(job->B, k, 0, 0), batch_at(job->C, k, 0, 0), A->rows, A->columns,
+                         job->B->columns);
+        } else if (job->op == BATCH_DET) {
+            double d[BATCH_LANES];
+            job->k->det(a, d, A->rows);
+            for (int t = 0; t < BATCH_LANES && k + t < A->count; t++)
+                job->det[k + t] = d[t];
+        } else {
+            // Пустые дорожки в конце последней группы вырождены, их не учитываем.
+            int bad = job->k->inverse(a, batch_at(job->C, k, 0, 0), A->rows);
+            for (int t = 0; t < BATCH_LANES && k + t < A->count; t++)
+                if (bad & (1 << t))
+                    ret = 2;
+        }
+    }
+
+    return ret;
+}
+
+#define BATCH_CASES(CALL) \
+    case 1: CALL(1); break; \
+    case 2: CALL(2); break; \
+    case 3: CALL(3); break; \
+    case 4: CALL(4); break; \
+    case 5: CALL(5); break; \
+    case 6: CALL(6); break; \
+    case 7: CALL(7); break; \
+    default: CALL(8); break;
+#define BATCH_MULT_N(N) BATCH_NAME(mult_group)(a + t, b + t, c + t, N, N, N)
+#define BATCH_DET_N(N) BATCH_NAME(det_group)(a + t, d + t, N)
+#define BATCH_INVERSE_N(N) mask |= BATCH_NAME(inverse_group)(a + t, r + t, N) << t
+
+// Ядра для каждого уровня SIMD: s21_batch_kernels.h подключается несколько раз со своей
+// шириной вектора BATCH_WIDTH и атрибутом target. SSE2 - базовый набор x86-64.
+#define BATCH_SUFFIX base
+#define BATCH_WIDTH 2
+#define BATCH_ATTR
+#include "s21_batch_kernels.h"
+#undef BATCH_SUFFIX
+#undef BATCH_WIDTH
+#undef BATCH_ATTR
+
+#if BATCH_X86
+#define BATCH_SUFFIX avx2
+#define BATCH_WIDTH 4
+#define BATCH_ATTR __attribute__((target("avx2,fma")))
+#include "s21_batch_kernels.h"
+#undef BATCH_SUFFIX
+#undef BATCH_WIDTH
+#undef BATCH_ATTR
+
+#define BATCH_SUFFIX avx512
+#define BATCH_WIDTH 8
+#define BATCH_ATTR __attribute__((target("avx512f")))
+#include "s21_batch_kernels.h"
+#undef BATCH_SUFFIX
+#undef BATCH_WIDTH
+#undef BATCH_ATTR
+#endif
+
+// Уровень берётся из общей настройки SIMD; SSE2 - базовый набор x86-64, ему соответствует base.
+static const batch_kernels_t *batch_kernels(void) {
+    const batch_kernels_t *k = &batch_base;
+#if BATCH_X86
+    if (s21_get_simd_level() == S21_SIMD_AVX2)
+        k = &batch_avx2;
+    else if (s21_get_simd_level() == S21_SIMD_AVX512)
+        k = &batch_avx512;
+#endif
+    return k;
+}
@@ -0,0 +1,168 @@
+// NOLINT(build/header_guard)
+// Шаблон ядер s21_batch.c: подключается один раз на уровень SIMD с заданными
+// BATCH_SUFFIX (суффикс имён), BATCH_WIDTH (дорожек в векторе) и BATCH_ATTR (target).
+
+typedef double BATCH_NAME(lane_t) __attribute__((vector_size(BATCH_WIDTH * sizeof(double))));
+typedef int64_t BATCH_NAME(mask_t) __attribute__((vector_size(BATCH_WIDTH * sizeof(double))));
+#define lane_t BATCH_NAME(lane_t)
+#define lane_mask_t BATCH_NAME(mask_t)
+
+BATCH_ATTR BATCH_INLINE void BATCH_NAME(mult_group)(const double *a, const double *b, double *c,
+                                                    int m, int p, int n) {
+    BATCH_UNROLL
+    for (int i = 0; i < m; i++)
+        BATCH_UNROLL
+        for (int j = 0; j < n; j++) {
+            lane_t acc = {0}, u, v;
+            BATCH_UNROLL
+            for (int l = 0; l < p; l++) {
+                LANE_LOAD(u, a + (i * p + l) * BATCH_LANES);
+                LANE_LOAD(v, b + (l * n + j) * BATCH_LANES);
+                acc += u * v;
+            }
+            LANE_STORE(c + (i * n + j) * BATCH_LANES, acc);
+        }
+}
+
+// Ведущий элемент в столбце k выбирается для каждой дорожки отдельно, строки меняются
+// через выбор по маске, а не ветвление, - все дорожки идут одним потоком команд.
+// Столбцы левее k в строках от k и ниже уже нулевые, их не трогаем.
+BATCH_ATTR BATCH_INLINE void BATCH_NAME(pivot_group)(lane_t w[][2 * S21_BATCH_MAX], int k, int n,
+                                                     int width, lane_t *sign) {
+    lane_t piv = LANE_ZERO + k;
+    lane_t best = LANE_ABS(w[k][k]);
+
+    BATCH_UNROLL
+    for (int y = k + 1; y < n; y++) {
+        lane_t v = LANE_ABS(w[y][k]);
+        lane_mask_t m = v > best;
+        piv = LANE_SELECT(m, LANE_ZERO + y, piv);
+        best = LANE_SELECT(m, v, best);
+    }
+    BATCH_UNROLL
+    for (int y = k + 1; y < n; y++) {
+        lane_mask_t m = piv == y;
+        BATCH_UNROLL
+        for (int x = k; x < width; x++) {
+            lane_t u = w[k][x], v = w[y][x];
+            w[k][x] = LANE_SELECT(m, v, u);
+            w[y][x] = LANE_SELECT(m, u, v);
+        }
+        *sign = LANE_SELECT(m, -*sign, *sign);
+    }
+}
+
+BATCH_ATTR BATCH_INLINE void BATCH_NAME(det_group)(const double *a, double *d, int n) {
+    lane_t w[S21_BATCH_MAX][2 * S21_BATCH_MAX];
+    lane_t det = LANE_ZERO + 1;
+
+    BATCH_UNROLL
+    for (int y = 0; y < n; y++)
+        BATCH_UNROLL
+        for (int x = 0; x < n; x++)
+            LANE_LOAD(w[y][x], a + (y * n + x) * BATCH_LANES);
+
+    BATCH_UNROLL
+    for (int k = 0; k < n; k++) {
+        BATCH_NAME(pivot_group)(w, k, n, n, &det);
+        det *= w[k][k];
+        lane_t inv = LANE_SELECT(w[k][k] != 0, 1 / w[k][k], LANE_ZERO);
+        BATCH_UNROLL
+        for (int y = k + 1; y < n; y++) {
+            lane_t l = w[y][k] * inv;
+            BATCH_UNROLL
+            for (int x = k + 1; x < n; x++)
+                w[y][x] -= l * w[k][x];
+        }
+    }
+    LANE_STORE(d, det);
+}
+
+// Гаусс-Жордан над [A | E] с тем же относительным порогом, что и s21_inverse_matrix.
+// Возвращает маску вырожденных дорожек, их результат обнуляется.
+BATCH_ATTR BATCH_INLINE int BATCH_NAME(inverse_group)(const double *a, double *r, int n) {
+    lane_t w[S21_BATCH_MAX][2 * S21_BATCH_MAX];
+    lane_t scale = {0}, sign = {0};
+    lane_mask_t bad = {0};
+    int mask = 0;
+
+    BATCH_UNROLL
+    for (int y = 0; y < n; y++)
+        BATCH_UNROLL
+        for (int x = 0; x < n; x++) {
+            LANE_LOAD(w[y][x], a + (y * n + x) * BATCH_LANES);
+            w[y][n + x] = LANE_ZERO + (x == y);
+            scale = LANE_SELECT(LANE_ABS(w[y][x]) > scale, LANE_ABS(w[y][x]), scale);
+        }
+
+    BATCH_UNROLL
+    for (int k = 0; k < n; k++) {
+        BATCH_NAME(pivot_group)(w, k, n, 2 * n, &sign);
+        lane_t p = w[k][k];
+        bad |= LANE_ABS(p) <= EPS * scale;
+        lane_t inv = LANE_SELECT(p != 0, 1 / p, LANE_ZERO);
+        BATCH_UNROLL
+        for (int x = k; x < 2 * n; x++)
+            w[k][x] *= inv;
+        BATCH_UNROLL
+        for (int y = 0; y < n; y++) {
+            lane_t l = y != k ? w[y][k] : LANE_ZERO;
+            BATCH_UNROLL
+            for (int x = k; x < 2 * n; x++)
+                w[y][x] -= l * w[k][x];
+        }
+    }
+
+    BATCH_UNROLL
+    for (int y = 0; y < n; y++)
+        BATCH_UNROLL
+        for (int x = 0; x < n; x++) {
+            w[y][n + x] = LANE_SELECT(bad, LANE_ZERO, w[y][n + x]);
+            LANE_STORE(r + (y * n + x) * BATCH_LANES, w[y][n + x]);
+        }
+    for (int t = 0; t < BATCH_WIDTH; t++)
+        if (bad[t])
+            mask |= 1 << t;
+
+    return mask;
+}
+
+// Группа из BATCH_LANES матриц обрабатывается векторами по BATCH_WIDTH дорожек. Для каждого
+// размера до S21_BATCH_MAX - своя копия ядра с постоянным n, циклы по матрице разворачиваются.
+BATCH_ATTR static void BATCH_NAME(mult)(const double *a, const double *b, double *c,
+                                        int m, int p, int n) {
+    for (int t = 0; t < BATCH_LANES; t += BATCH_WIDTH) {
+        if (m == p && p == n) {
+            switch (n) {
+                BATCH_CASES(BATCH_MULT_N)
+            }
+        } else {
+            BATCH_NAME(mult_group)(a + t, b + t, c + t, m, p, n);
+        }
+    }
+}
+
+BATCH_ATTR static void BATCH_NAME(det)(const double *a, double *d, int n) {
+    for (int t = 0; t < BATCH_LANES; t += BATCH_WIDTH) {
+        switch (n) {
+            BATCH_CASES(BATCH_DET_N)
+        }
+    }
+}
+
+BATCH_ATTR static int BATCH_NAME(inverse)(const double *a, double *r, int n) {
+    int mask = 0;
+
+    for (int t = 0; t < BATCH_LANES; t += BATCH_WIDTH) {
+        switch (n) {
+            BATCH_CASES(BATCH_INVERSE_N)
+        }
+    }
+
+    return mask;
+}
+
+static const batch_kernels_t BATCH_NAME(batch) = {BATCH_NAME(mult), BATCH_NAME(det), BATCH_NAME(inverse)};
+
+#undef lane_t
+#undef lane_mask_t
@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include "s21_matrix.h"
+
+// Записей не больше CACHE_ENTRIES; матрицы меньше CACHE_MIN_ROWS считаются быстрее, чем хешируются.
+#define CACHE_ENTRIES  64
+#define CACHE_MIN_ROWS 8
+
+// data - копия входа по строкам (по ней проверяется совпадение, хеш только отбирает
+// кандидатов), за ней - копия результата-матрицы того же размера, если она есть.
+typedef struct cache_entry {
+    cache_key_t key;
+    int         rows;
+    int         columns;
+    int         has_result;
+    double      *data;
+    double      number;
+    size_t      bytes;
+    uint64_t    used;
+} cache_entry_t;
+
+// used - номер последнего обращения (0 - запись свободна), вытесняется наименьший.
+typedef struct result_cache {
+    pthread_mutex_t lock;
+    size_t          max_bytes;
+    size_t          bytes;
+    uint64_t        tick;
+    uint64_t        hits;
+    uint64_t        misses;
+    uint64_t        evictions;
+    cache_entry_t   entries[CACHE_ENTRIES];
+} result_cache_t;
+
+static result_cache_t cache = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+static uint64_t hash_data(const double *a, int rows, int columns);
+static uint64_t hash_mix(uint64_t x);
+static cache_entry_t *cache_find_locked(const cache_key_t *key, int rows, int columns, const double *a);
+static cache_entry_t *cache_slot_locked(size_t bytes);
+static cache_entry_t *cache_oldest_locked(void);
+static void cache_evict_locked(cache_entry_t *e);
+static void cache_drop_locked(cache_entry_t *e);
+
+uint64_t s21_matrix_hash(matrix_t *A) {
+    uint64_t hash = 0;
+    double *tmp = NULL;
+    const double *a = matrix_is_empty(A) ? NULL : oriented_data(A, 0, &tmp);
+
+    if (a != NULL)
+        hash = hash_data(a, A->rows, A->columns);
+    scratch_free(tmp);
+
+    return hash;
+}
+
+// 0 выключает кэш и освобождает все записи; при уменьшении лимита лишнее вытесняется.
+void s21_set_cache_limit(size_t max_bytes) {
+    pthread_mutex_lock(&cache.lock);
+    __atomic_store_n(&cache.max_bytes, max_bytes, __ATOMIC_RELAXED);
+    while (cache.bytes > max_bytes)
+        cache_evict_locked(cache_oldest_locked());
+    pthread_mutex_unlock(&cache.lock);
+}
+
+void s21_cache_clear(void) {
+    pthread_mutex_lock(&cache.lock);
+    for (int i = 0; i < CACHE_ENTRIES; i++)
+        if (cache.entries[i].used != 0)
+            cache_drop_locked(&cache.entries[i]);
+    pthread_mutex_unlock(&cache.lock);
+}
+
+void s21_cache_snapshot(s21_cache_stats_t *result) {
+    pthread_mutex_lock(&cache.lock);
+    result->hits = cache.hits;
+    result->misses = cache.misses;
+    result->evictions = cache.evictions;
+    result->bytes = cache.bytes;
+    result->max_bytes = cache.max_bytes;
+    result->entries = 0;
+    for (int i = 0; i < CACHE_ENTRIES; i++)
+        result->entries += cache.entries[i].used != 0;
+    pthread_mutex_unlock(&cache.lock);
+}
+
+/*
+ * Ищет результат операции op для A. 0 - найден: number и/или result (создаётся) заполнены.
+ * Иначе key запоминает хеш для cache_store. Выключенный кэш и малые матрицы не хешируются.
+ */
+int cache_lookup(int op, matrix_t *A, cache_key_t *key, double *number, matrix_t *result) {
+    int ret = 1;
+    double *tmp = NULL;
+    const double *a = NULL;
+    key->op = op;
+    key->valid = 0;
+    key->hash = 0;
+
+    if (__atomic_load_n(&cache.max_bytes, __ATOMIC_RELAXED) > 0 && A->rows >= CACHE_MIN_ROWS &&
+        A->columns >= CACHE_MIN_ROWS && (a = oriented_data(A, 0, &tmp)) != NULL) {
+        key->hash = hash_data(a, A->rows, A->columns);
+        key->valid = 1;
+        pthread_mutex_lock(&cache.lock);
+        cache_entry_t *e = cache_find_locked(key, A->rows, A->columns, a);
+        size_t size = (size_t)A->rows * A->columns;
+        if (e != NULL && (!e->has_result || s21_create_matrix(A->rows, A->columns, result) == 0)) {
+            if (e->has_result)
+                memcpy(result->matrix[0], e->data + size, size * sizeof(double));
+            if (number != NULL)
+                *number = e->number;
+            e->used = ++cache.tick;
+            ret = 0;
+        }
+        if (ret == 0)
+            cache.hits++;
+        else
+            cache.misses++;
+        pthread_mutex_unlock(&cache.lock);
+    }
+    scratch_free(tmp);
+
+    return ret;
+}
+
+// Копии делаются вне блокировки; запись больше лимита и уже добавленный другим потоком вход пропускаются.
+void cache_store(const cache_key_t *key, matrix_t *A, double number, matrix_t *result) {
+    double *tmp = NULL, *data = NULL;
+    size_t size = (size_t)A->rows * A->columns;
+    size_t bytes = sizeof(double) * size * (result != NULL ? 2 : 1);
+    const double *a = key->valid ? oriented_data(A, 0, &tmp) : NULL;
+
+    if (a != NULL && (data = (double *)malloc(bytes)) != NULL) {
+        memcpy(data, a, size * sizeof(double));
+        if (result != NULL)
+            memcpy(data + size, result->matrix[0], size * sizeof(double));
+        pthread_mutex_lock(&cache.lock);
+        if (bytes <= cache.max_bytes && cache_find_locked(key, A->rows, A->columns, a) == NULL) {
+            cache_entry_t *e = cache_slot_locked(bytes);
+            e->key = *key;
+            e->rows = A->rows;
+            e->columns = A->columns;
+            e->has_result = result != NULL;
+            e->data = data;
+            e->number = number;
+            e->bytes = bytes;
+            e->used = ++cache.tick;
+            cache.bytes += bytes;
+            data = NULL;
+        }
+        pthread_mutex_unlock(&cache.lock);
+    }
+    free(data);
+    scratch_free(tmp);
+}
+
+// Хеш зависит от размеров: 2 x 3 и 3 x 2 с одинаковыми данными различаются.
+static uint64_t hash_data(const double *a, int rows, int columns) {
+    uint64_t acc[S21_HASH_LANES] = {0};
+    double tail[S21_HASH_LANES] = {0};
+    size_t size = (size_t)rows * columns, stripes = size / S21_HASH_LANES;
+    uint64_t hash = hash_mix((uint64_t)rows << 32 | (uint32_t)columns);
+
+    vec_hash(acc, a, stripes, 0);
+    if (size % S21_HASH_LANES != 0) {
+        memcpy(tail, a + stripes * S21_HASH_LANES, (size % S21_HASH_LANES) * sizeof(double));
+        vec_hash(acc, tail, 1, stripes);
+    }
+    for (int l = 0; l < S21_HASH_LANES; l++)
+        hash = hash_mix(hash ^ acc[l]);
+
+    return hash;
+}
+
+// Финальное перемешивание splitmix64.
+static uint64_t hash_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static cache_entry_t *cache_find_locked(const cache_key_t *key, int rows, int columns, const double *a) {
+    cache_entry_t *found = NULL;
+
+    for (int i = 0; i < CACHE_ENTRIES && found == NULL; i++) {
+        cache_entry_t *e = &cache.entries[i];
+        if (e->used != 0 && e->key.op == key->op && e->key.hash == key->hash && e->rows == rows &&
+            e->columns == columns && memcmp(e->data, a, (size_t)rows * columns * sizeof(double)) == 0)
+            found = e;
+    }
+
+    return found;
+}
+
+// Свободная запись с местом под bytes (не больше max_bytes): давно не использованные вытесняются.
+static cache_entry_t *cache_slot_locked(size_t bytes) {
+    cache_entry_t *slot = NULL;
+
+    while (cache.bytes + bytes > cache.max_bytes)
+        cache_evict_locked(cache_oldest_locked());
+    for (int i = 0; i < CACHE_ENTRIES && slot == NULL; i++)
+        if (cache.entries[i].used == 0)
+            slot = &cache.entries[i];
+    if (slot == NULL) {
+        slot = cache_oldest_locked();
+        cache_evict_locked(slot);
+    }
+
+    return slot;
+}
+
+static cache_entry_t *cache_oldest_locked(void) {
+    cache_entry_t *oldest = NULL;
+
+    for (int i = 0; i < CACHE_ENTRIES; i++) {
+        cache_entry_t *e = &cache.entries[i];
+        if (e->used != 0 && (oldest == NULL || e->used < oldest->used))
+            oldest = e;
+    }
+
+    return oldest;
+}
+
+static void cache_evict_locked(cache_entry_t *e) {
+    cache_drop_locked(e);
+    cache.evictions++;
+}
+
+static void cache_drop_locked(cache_entry_t *e) {
+    free(e->data);
+    cache.bytes -= e->bytes;
+    e->data = NULL;
+    e->bytes = 0;
+    e->used = 0;
+}
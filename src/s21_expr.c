@@ -0,0 +1,223 @@
+#include "s21_matrix.h"
+
+// Поэлементная часть считается кусками по EXPR_CHUNK элементов: кусок результата остаётся в
+// кэше, пока к нему прибавляются все слагаемые, и каждый операнд читается из памяти один раз.
+#define EXPR_CHUNK 1024
+
+// Слагаемое coefficient * matrix или coefficient * (произведение узла node).
+typedef struct expr_term {
+    double      coefficient;
+    matrix_t    *matrix;
+    int         node;
+} expr_term_t;
+
+static int expr_add(s21_expr_t *expr, int op, int left, int right, double number, matrix_t *matrix);
+static int expr_shapes(const s21_expr_t *expr, int root, int *rows, int *columns);
+static void expr_terms(const s21_expr_t *expr, int root, expr_term_t *terms, int *count);
+static int expr_combine(expr_term_t *terms, int count, matrix_t *result);
+static int expr_operand(s21_expr_t *expr, int node, matrix_t *tmp, matrix_t **operand);
+
+void s21_expr_init(s21_expr_t *expr) {
+    expr->count = 0;
+}
+
+int s21_expr_matrix(s21_expr_t *expr, matrix_t *A) {
+    return matrix_is_empty(A) ? -1 : expr_add(expr, S21_EXPR_MATRIX, -1, -1, 0, A);
+}
+
+int s21_expr_sum(s21_expr_t *expr, int a, int b) {
+    return expr_add(expr, S21_EXPR_SUM, a, b, 0, NULL);
+}
+
+int s21_expr_sub(s21_expr_t *expr, int a, int b) {
+    return expr_add(expr, S21_EXPR_SUB, a, b, 0, NULL);
+}
+
+int s21_expr_scale(s21_expr_t *expr, int a, double number) {
+    return expr_add(expr, S21_EXPR_SCALE, a, a, number, NULL);
+}
+
+int s21_expr_mult(s21_expr_t *expr, int a, int b) {
+    return expr_add(expr, S21_EXPR_MULT, a, b, 0, NULL);
+}
+
+/*
+ * Сумма, разность и умножение на число раскрываются в линейную комбинацию
+ * coefficient * операнд: (A + B) * c - D = cA + cB - D, одинаковые операнды складываются.
+ * Матрицы комбинации проходятся одним проходом без временных матриц, произведения
+ * прибавляются к результату через gemm с alpha = coefficient (умножение со сложением).
+ * Порядок округлений поэтому может отличаться от цепочки s21_sum_matrix/s21_mult_number.
+ */
+int s21_eval(s21_expr_t *expr, int root, matrix_t *result) {
+    STATS_BEGIN();
+    int ret = 0, rows[S21_EXPR_NODES], columns[S21_EXPR_NODES], count = 0;
+    expr_term_t terms[S21_EXPR_NODES];
+    double flops = 0;
+    result->matrix = NULL;
+    result->rows = 0;
+    result->columns = 0;
+    result->flags = 0;
+
+    if (expr == NULL || root < 0 || root >= expr->count) {
+        ret = 1;
+    } else if (expr_shapes(expr, root, rows, columns) != 0) {
+        ret = 2;
+    } else if (s21_create_matrix(rows[root], columns[root], result) != 0) {
+        ret = 2;
+    } else {
+        expr_terms(expr, root, terms, &count);
+        ret = expr_combine(terms, count, result);
+        flops = 2.0 * count * rows[root] * columns[root];
+    }
+
+    for (int i = 0; i < count && ret == 0; i++) {
+        const s21_expr_node_t *node = &expr->nodes[terms[i].node];
+        matrix_t ta = {NULL, 0, 0, 0}, tb = {NULL, 0, 0, 0}, *a = NULL, *b = NULL;
+        int product = terms[i].matrix == NULL && terms[i].coefficient != 0;
+        if (product && (expr_operand(expr, node->left, &ta, &a) != 0 ||
+                        expr_operand(expr, node->right, &tb, &b) != 0)) {
+            ret = 2;
+        } else if (product) {
+            int rsa, csa, rsb, csb;
+            matrix_strides(a, &rsa, &csa);
+            matrix_strides(b, &rsb, &csb);
+            ret = gemm_blocked(a->rows, b->columns, a->columns, terms[i].coefficient, a->matrix[0], rsa, csa,
+                               b->matrix[0], rsb, csb, result->matrix[0], result->columns);
+            flops += 2.0 * a->rows * a->columns * b->columns;
+        }
+        s21_remove_matrix(&ta);
+        s21_remove_matrix(&tb);
+    }
+    if (ret == 2)
+        s21_remove_matrix(result);
+
+    STATS_END(eval, ret ? 0 : flops);
+    return ret;
+}
+
+// Операнды - только уже добавленные узлы, поэтому номера узлов задают порядок вычисления.
+static int expr_add(s21_expr_t *expr, int op, int left, int right, double number, matrix_t *matrix) {
+    int ret = -1;
+
+    if (expr != NULL && expr->count < S21_EXPR_NODES &&
+        (op == S21_EXPR_MATRIX || (left >= 0 && left < expr->count && right >= 0 && right < expr->count))) {
+        s21_expr_node_t *node = &expr->nodes[expr->count];
+        node->op = op;
+        node->left = left;
+        node->right = right;
+        node->number = number;
+        node->matrix = matrix;
+        ret = expr->count++;
+    }
+
+    return ret;
+}
+
+// Размеры проверяются только у узлов, от которых зависит root.
+static int expr_shapes(const s21_expr_t *expr, int root, int *rows, int *columns) {
+    int ret = 0, reached[S21_EXPR_NODES] = {0};
+    reached[root] = 1;
+
+    for (int i = root; i >= 0; i--) {
+        if (reached[i] && expr->nodes[i].op != S21_EXPR_MATRIX)
+            reached[expr->nodes[i].left] = reached[expr->nodes[i].right] = 1;
+    }
+    for (int i = 0; i <= root && ret == 0; i++) {
+        const s21_expr_node_t *node = &expr->nodes[i];
+        int l = node->left, r = node->right;
+        if (!reached[i]) {
+            rows[i] = columns[i] = 0;
+        } else if (node->op == S21_EXPR_MATRIX) {
+            rows[i] = node->matrix->rows;
+            columns[i] = node->matrix->columns;
+        } else if (node->op == S21_EXPR_MULT) {
+            ret = columns[l] != rows[r];
+            rows[i] = rows[l];
+            columns[i] = columns[r];
+        } else {
+            ret = rows[l] != rows[r] || columns[l] != columns[r];
+            rows[i] = rows[l];
+            columns[i] = columns[l];
+        }
+    }
+
+    return ret;
+}
+
+// Коэффициенты спускаются от корня к операндам в обратном порядке узлов: общие подвыражения
+// обходятся один раз, сколько бы раз на них ни ссылались.
+static void expr_terms(const s21_expr_t *expr, int root, expr_term_t *terms, int *count) {
+    double coefficient[S21_EXPR_NODES] = {0};
+    int reached[S21_EXPR_NODES] = {0};
+    coefficient[root] = 1;
+    reached[root] = 1;
+
+    for (int i = root; i >= 0; i--) {
+        const s21_expr_node_t *node = &expr->nodes[i];
+        int l = node->left, r = node->right;
+        if (!reached[i])
+            continue;
+        if (node->op == S21_EXPR_SUM || node->op == S21_EXPR_SUB) {
+            coefficient[l] += coefficient[i];
+            coefficient[r] += node->op == S21_EXPR_SUM ? coefficient[i] : -coefficient[i];
+            reached[l] = reached[r] = 1;
+        } else if (node->op == S21_EXPR_SCALE) {
+            coefficient[l] += coefficient[i] * node->number;
+            reached[l] = 1;
+        } else {
+            expr_term_t term = {coefficient[i], node->matrix, i};
+            int same = -1;
+            for (int k = 0; k < *count && node->op == S21_EXPR_MATRIX; k++)
+                same = terms[k].matrix == node->matrix ? k : same;
+            if (same >= 0)
+                terms[same].coefficient += term.coefficient;
+            else
+                terms[(*count)++] = term;
+        }
+    }
+}
+
+// result = сумма coefficient * matrix по слагаемым-матрицам, кусками по EXPR_CHUNK.
+static int expr_combine(expr_term_t *terms, int count, matrix_t *result) {
+    int ret = 0, used = 0;
+    size_t size = (size_t)result->rows * result->columns;
+    const double *data[S21_EXPR_NODES];
+    double coefficient[S21_EXPR_NODES], *tmp[S21_EXPR_NODES];
+    double *r = result->matrix[0];
+
+    for (int i = 0; i < count; i++) {
+        if (terms[i].matrix != NULL && terms[i].coefficient != 0) {
+            tmp[used] = NULL;
+            coefficient[used] = terms[i].coefficient;
+            data[used] = oriented_data(terms[i].matrix, 0, &tmp[used]);
+            ret = data[used++] == NULL ? 2 : ret;
+        }
+    }
+
+    if (ret == 0 && used == 0)
+        memset(r, 0, size * sizeof(double));
+    for (size_t start = 0; start < size && ret == 0 && used > 0; start += EXPR_CHUNK) {
+        size_t n = size - start < EXPR_CHUNK ? size - start : EXPR_CHUNK;
+        vec_scale(r + start, data[0] + start, coefficient[0], n);
+        for (int k = 1; k < used; k++)
+            vec_axpy(r + start, data[k] + start, coefficient[k], n);
+    }
+    for (int k = 0; k < used; k++)
+        scratch_free(tmp[k]);
+
+    return ret;
+}
+
+// Лист используется как есть (транспонированный - через шаги), остальное вычисляется в tmp.
+static int expr_operand(s21_expr_t *expr, int node, matrix_t *tmp, matrix_t **operand) {
+    int ret = 0;
+
+    if (expr->nodes[node].op == S21_EXPR_MATRIX) {
+        *operand = expr->nodes[node].matrix;
+    } else {
+        ret = s21_eval(expr, node, tmp);
+        *operand = tmp;
+    }
+
+    return ret;
+}
@@ -0,0 +1,192 @@
+#include "s21_matrix.h"
+
+// Вырожденность - как в s21_inverse_matrix: относительно наибольшего по модулю элемента.
+#define FIXED_SINGULAR(A, N, det) fixed_singular(&(A)->m[0][0], (N) * (N), (N), (det))
+
+static int fixed_singular(const double *a, int count, int n, double det);
+
+// Перенос между matrix_t и фиксированным типом; учитывает ленивое транспонирование.
+#define FIXED_CONVERT(N) \
+    int s21_mat##N##_from(matrix_t *A, s21_mat##N##_t *result) { \
+        int ret = matrix_is_empty(A) ? 1 : A->rows != N || A->columns != N ? 2 : 0; \
+        if (ret == 0) \
+            matrix_to_buffer(A, &result->m[0][0]); \
+        return ret; \
+    } \
+    int s21_mat##N##_to(const s21_mat##N##_t *A, matrix_t *result) { \
+        int ret = s21_create_matrix(N, N, result); \
+        if (ret == 0) \
+            memcpy(result->matrix[0], A->m, sizeof(A->m)); \
+        return ret; \
+    } \
+    void s21_mat##N##_mult(const s21_mat##N##_t *A, const s21_mat##N##_t *B, s21_mat##N##_t *result) { \
+        s21_mat##N##_t r; \
+        for (int y = 0; y < N; y++) \
+            for (int x = 0; x < N; x++) { \
+                double sum = 0; \
+                for (int k = 0; k < N; k++) \
+                    sum += A->m[y][k] * B->m[k][x]; \
+                r.m[y][x] = sum; \
+            } \
+        *result = r; \
+    }
+
+FIXED_CONVERT(2)
+FIXED_CONVERT(3)
+FIXED_CONVERT(4)
+
+double s21_mat2_det(const s21_mat2_t *A) {
+    const double (*a)[2] = A->m;
+    return a[0][0] * a[1][1] - a[1][0] * a[0][1];
+}
+
+// Тот же порядок действий, что и в s21_view_determinant, - результаты совпадают побитово.
+double s21_mat3_det(const s21_mat3_t *A) {
+    const double (*a)[3] = A->m;
+    return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+         - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+         + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+}
+
+// Разложение Лапласа по двум верхним строкам: 12 миноров 2x2 вместо 4 миноров 3x3.
+#define MAT4_MINORS(a) \
+    double s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1]; \
+    double s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2]; \
+    double s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3]; \
+    double s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2]; \
+    double s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3]; \
+    double s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3]; \
+    double c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3]; \
+    double c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3]; \
+    double c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2]; \
+    double c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3]; \
+    double c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2]; \
+    double c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+double s21_mat4_det(const s21_mat4_t *A) {
+    const double (*a)[4] = A->m;
+    MAT4_MINORS(a)
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+int s21_mat2_inverse(const s21_mat2_t *A, s21_mat2_t *result) {
+    const double (*a)[2] = A->m;
+    double det = s21_mat2_det(A);
+    int ret = FIXED_SINGULAR(A, 2, det);
+
+    if (ret == 0) {
+        s21_mat2_t r = {{{a[1][1] / det, -a[0][1] / det}, {-a[1][0] / det, a[0][0] / det}}};
+        *result = r;
+    }
+
+    return ret;
+}
+
+int s21_mat3_inverse(const s21_mat3_t *A, s21_mat3_t *result) {
+    const double (*a)[3] = A->m;
+    double det = s21_mat3_det(A);
+    int ret = FIXED_SINGULAR(A, 3, det);
+
+    if (ret == 0) {
+        double adj[3][3] = {
+            {a[1][1] * a[2][2] - a[1][2] * a[2][1], a[0][2] * a[2][1] - a[0][1] * a[2][2],
+             a[0][1] * a[1][2] - a[0][2] * a[1][1]},
+            {a[1][2] * a[2][0] - a[1][0] * a[2][2], a[0][0] * a[2][2] - a[0][2] * a[2][0],
+             a[0][2] * a[1][0] - a[0][0] * a[1][2]},
+            {a[1][0] * a[2][1] - a[1][1] * a[2][0], a[0][1] * a[2][0] - a[0][0] * a[2][1],
+             a[0][0] * a[1][1] - a[0][1] * a[1][0]}};
+        for (int y = 0; y < 3; y++)
+            for (int x = 0; x < 3; x++)
+                result->m[y][x] = adj[y][x] / det;
+    }
+
+    return ret;
+}
+
+int s21_mat4_inverse(const s21_mat4_t *A, s21_mat4_t *result) {
+    const double (*a)[4] = A->m;
+    MAT4_MINORS(a)
+    double det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    int ret = FIXED_SINGULAR(A, 4, det);
+
+    if (ret == 0) {
+        double adj[4][4] = {
+            {a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3, -a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3,
+             a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3, -a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3},
+            {-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1, a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1,
+             -a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1, a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1},
+            {a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0, -a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0,
+             a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0, -a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0},
+            {-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0, a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0,
+             -a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0, a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0}};
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 4; x++)
+                result->m[y][x] = adj[y][x] / det;
+    }
+
+    return ret;
+}
+
+// Ветки s21_determinant, s21_inverse_matrix и s21_mult_matrix для n = 2..4.
+#define FIXED_CASES(CALL) \
+    case 2: CALL(2); break; \
+    case 3: CALL(3); break; \
+    default: CALL(4); break;
+
+double fixed_determinant(matrix_t *A) {
+    double det = 0;
+
+#define FIXED_DET_N(N) { \
+        s21_mat##N##_t a; \
+        s21_mat##N##_from(A, &a); \
+        det = s21_mat##N##_det(&a); \
+    }
+    switch (A->rows) { FIXED_CASES(FIXED_DET_N) }
+
+    return det;
+}
+
+/*
+ * result уже создана; при ненулевом коде она не заполняется. Порог s21_inverse_matrix - ведущий
+ * элемент метода Гаусса <= EPS * max|a|, а по определителю его можно только оценить: при частичном
+ * выборе |u_kk| <= 2^(k-1) * max|a|, поэтому любой малый ведущий элемент даёт
+ * |det| <= 2^(n(n-1)/2) * EPS * max|a|^n. Явные формулы берутся только выше этой границы,
+ * ближе к ней код 2 отправляет вызывающего в метод Гаусса-Жордана, который и решает.
+ */
+int fixed_inverse(matrix_t *A, matrix_t *result) {
+    int ret = 0;
+
+#define FIXED_INVERSE_N(N) { \
+        s21_mat##N##_t a; \
+        s21_mat##N##_from(A, &a); \
+        ret = FIXED_SINGULAR(&a, N, s21_mat##N##_det(&a) / (1 << ((N) * ((N) - 1) / 2))); \
+        if (ret == 0) \
+            ret = s21_mat##N##_inverse(&a, (s21_mat##N##_t *)result->matrix[0]); \
+    }
+    switch (A->rows) { FIXED_CASES(FIXED_INVERSE_N) }
+
+    return ret;
+}
+
+void fixed_mult(matrix_t *A, matrix_t *B, matrix_t *result) {
+#define FIXED_MULT_N(N) { \
+        s21_mat##N##_t a, b; \
+        s21_mat##N##_from(A, &a); \
+        s21_mat##N##_from(B, &b); \
+        s21_mat##N##_mult(&a, &b, (s21_mat##N##_t *)result->matrix[0]); \
+    }
+    switch (A->rows) { FIXED_CASES(FIXED_MULT_N) }
+}
+
+// |det| <= EPS * max|a|^n: масштаб порога ведущего элемента в методе Гаусса, но не сам порог.
+static int fixed_singular(const double *a, int count, int n, double det) {
+    double scale = 0, bound = EPS;
+
+    for (int i = 0; i < count; i++)
+        if (fabs(a[i]) > scale)
+            scale = fabs(a[i]);
+    for (int i = 0; i < n; i++)
+        bound *= scale;
+
+    return scale == 0 || !(fabs(det) > bound) ? 2 : 0;
+}
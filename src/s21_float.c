@@ -0,0 +1,357 @@
+#include <float.h>
+#include "s21_matrix.h"
+
+// Операции над матрицами float и решение систем со смешанной точностью. Раскладка блока и
+// LU-разложение общие с double (шаблон s21_real_kernels.h, экземпляры в s21_lu.c).
+
+// Ширина полосы строк B в умножении: полоса остаётся в кэше, пока по ней проходят все строки A.
+#define FLOAT_KC 256
+
+// Сколько шагов уточнения допускается до перехода на разложение в double (как в dsgesv).
+#define MIXED_ITERATIONS 30
+
+static double norm_max(const double *a, size_t size);
+
+int s21_create_matrixf(int rows, int columns, matrixf_t *result) {
+    int ret = 0;
+    size_t bytes = matrix_bytesf(rows, columns);
+    void *mem = NULL;
+
+    if (rows < 1 || columns < 1) {
+        ret = 1;
+    } else if (bytes == 0 || (mem = matrix_block_alloc(bytes)) == NULL) {
+        ret = 2;
+    } else {
+        matrix_layoutf(mem, rows, columns, result);
+    }
+    if (ret != 0) {
+        result->matrix = NULL;
+        result->rows = 0;
+        result->columns = 0;
+        result->flags = 0;
+    }
+
+    return ret;
+}
+
+void s21_remove_matrixf(matrixf_t *A) {
+    if (A->matrix != NULL)
+        matrix_block_release(A->matrix);
+    A->matrix = NULL;
+    A->rows = 0;
+    A->columns = 0;
+    A->flags = 0;
+}
+
+int s21_eq_matrixf(matrixf_t *A, matrixf_t *B) {
+    int ret = A->matrix != NULL && B->matrix != NULL && A->rows == B->rows && A->columns == B->columns;
+    size_t size = (size_t)A->rows * A->columns;
+
+    for (size_t i = 0; i < size && ret; i++)
+        ret = fabs((double)A->matrix[0][i] - (double)B->matrix[0][i]) < EPSF;
+
+    return ret;
+}
+
+// Поэлементные циклы без ветвлений компилятор векторизует на всю ширину регистра.
+int s21_sum_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL || B->matrix == NULL) {
+        ret = 1;
+    } else if (A->rows != B->rows || A->columns != B->columns) {
+        ret = 2;
+    } else if (s21_create_matrixf(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        const float *a = A->matrix[0], *b = B->matrix[0];
+        float *r = result->matrix[0];
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            r[i] = a[i] + b[i];
+    }
+
+    return ret;
+}
+
+int s21_sub_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL || B->matrix == NULL) {
+        ret = 1;
+    } else if (A->rows != B->rows || A->columns != B->columns) {
+        ret = 2;
+    } else if (s21_create_matrixf(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        const float *a = A->matrix[0], *b = B->matrix[0];
+        float *r = result->matrix[0];
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            r[i] = a[i] - b[i];
+    }
+
+    return ret;
+}
+
+int s21_mult_numberf(matrixf_t *A, float number, matrixf_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL) {
+        ret = 1;
+    } else if (s21_create_matrixf(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        const float *a = A->matrix[0];
+        float *r = result->matrix[0];
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            r[i] = a[i] * number;
+    }
+
+    return ret;
+}
+
+int s21_mult_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL || B->matrix == NULL) {
+        ret = 1;
+    } else if (A->columns != B->rows) {
+        ret = 2;
+    } else if (s21_create_matrixf(A->rows, B->columns, result) != 0) {
+        ret = 2;
+    } else {
+        int n = B->columns;
+        for (int pc = 0; pc < A->columns; pc += FLOAT_KC) {
+            int kc = A->columns - pc < FLOAT_KC ? A->columns - pc : FLOAT_KC;
+            for (int y = 0; y < A->rows; y++) {
+                float *r = result->matrix[y];
+                for (int p = pc; p < pc + kc; p++)
+                    vec_axpyf(r, B->matrix[p], A->matrix[y][p], (size_t)n);
+            }
+        }
+    }
+
+    return ret;
+}
+
+int s21_transposef(matrixf_t *A, matrixf_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL) {
+        ret = 1;
+    } else if (s21_create_matrixf(A->columns, A->rows, result) != 0) {
+        ret = 2;
+    } else {
+        for (int y = 0; y < A->rows; y++)
+            for (int x = 0; x < A->columns; x++)
+                result->matrix[x][y] = A->matrix[y][x];
+    }
+
+    return ret;
+}
+
+/*
+ * Миноры считаются отдельными разложениями, O(n^5): как и в double, дополнения есть и у
+ * вырожденной A. У 1 x 1 единственное дополнение - определитель пустой матрицы, 1.
+ */
+int s21_calc_complementsf(matrixf_t *A, matrixf_t *result) {
+    int ret = 0, n = A->rows;
+    matrixf_t minor = {NULL, 0, 0, 0};
+
+    if (A->matrix == NULL) {
+        ret = 1;
+    } else if (A->rows != A->columns) {
+        ret = 2;
+    } else if (s21_create_matrixf(n, n, result) != 0) {
+        ret = 2;
+    } else if (n == 1) {
+        result->matrix[0][0] = 1;
+    } else if (s21_create_matrixf(n - 1, n - 1, &minor) != 0) {
+        ret = 2;
+        s21_remove_matrixf(result);
+    } else {
+        for (int y = 0; y < n && ret == 0; y++)
+            for (int x = 0; x < n && ret == 0; x++) {
+                float det = 0;
+                for (int my = 0; my < n - 1; my++)
+                    for (int mx = 0; mx < n - 1; mx++)
+                        minor.matrix[my][mx] = A->matrix[my + (my >= y)][mx + (mx >= x)];
+                ret = s21_determinantf(&minor, &det);
+                result->matrix[y][x] = (y + x) % 2 ? -det : det;
+            }
+        if (ret != 0)
+            s21_remove_matrixf(result);
+        s21_remove_matrixf(&minor);
+    }
+
+    return ret;
+}
+
+int s21_determinantf(matrixf_t *A, float *result) {
+    s21_luf_t lu;
+    int ret = s21_lu_factorf(A, &lu);
+
+    if (ret == 0)
+        s21_lu_detf(&lu, result);
+    s21_lu_freef(&lu);
+
+    return ret;
+}
+
+// Вырожденность - как у s21_lu_singularf: ведущий элемент не больше EPSF * max|a|.
+int s21_inverse_matrixf(matrixf_t *A, matrixf_t *result) {
+    s21_luf_t lu;
+    int ret = s21_lu_factorf(A, &lu);
+
+    result->matrix = NULL;
+    if (ret == 0)
+        ret = s21_lu_inversef(&lu, result);
+    s21_lu_freef(&lu);
+
+    return ret;
+}
+
+int s21_sum_matrix_inplacef(matrixf_t *A, matrixf_t *B) {
+    return s21_axpyf(1, B, A);
+}
+
+int s21_sub_matrix_inplacef(matrixf_t *A, matrixf_t *B) {
+    return s21_axpyf(-1, B, A);
+}
+
+int s21_mult_number_inplacef(matrixf_t *A, float number) {
+    int ret = A->matrix == NULL;
+
+    for (size_t i = 0; i < (size_t)A->rows * A->columns && ret == 0; i++)
+        A->matrix[0][i] *= number;
+
+    return ret;
+}
+
+// Y += alpha * X.
+int s21_axpyf(float alpha, matrixf_t *X, matrixf_t *Y) {
+    int ret = 0;
+
+    if (X->matrix == NULL || Y->matrix == NULL)
+        ret = 1;
+    else if (X->rows != Y->rows || X->columns != Y->columns)
+        ret = 2;
+    else
+        vec_axpyf(Y->matrix[0], X->matrix[0], alpha, (size_t)X->rows * X->columns);
+
+    return ret;
+}
+
+int s21_matrix_to_float(matrix_t *A, matrixf_t *result) {
+    int ret = 0;
+    double *tmp = NULL;
+    const double *a = NULL;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+        result->matrix = NULL;
+    } else if ((a = oriented_data(A, 0, &tmp)) == NULL ||
+               s21_create_matrixf(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            result->matrix[0][i] = (float)a[i];
+    }
+    scratch_free(tmp);
+
+    return ret;
+}
+
+int s21_matrix_from_float(matrixf_t *A, matrix_t *result) {
+    int ret = 0;
+
+    if (A->matrix == NULL) {
+        ret = 1;
+        result->matrix = NULL;
+    } else if (s21_create_matrix(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            result->matrix[0][i] = A->matrix[0][i];
+    }
+
+    return ret;
+}
+
+/*
+ * LU считается во float: вдвое меньше памяти и вдвое шире SIMD. Решение уточняется по
+ * невязке R = B - A X в double, поправка решается тем же float-разложением, пока
+ * ||R|| не станет порядка ||A|| ||X|| DBL_EPSILON sqrt(n). Если float-разложение вырождено
+ * или уточнение не сходится (cond(A) порядка 1 / FLT_EPSILON и больше), система решается
+ * s21_lu_factor в double. iterations (может быть NULL) - число шагов или -1 при переходе на double.
+ */
+int s21_solve_mixed(matrix_t *A, matrix_t *B, matrix_t *X, int *iterations) {
+    int ret = 0, done = 0, steps = 0, n = A->rows, m = B->columns;
+    double *ta = NULL, *tb = NULL, *r = NULL;
+    const double *a = NULL, *b = NULL;
+    float *r32 = NULL;
+    matrixf_t af = {NULL, 0, 0, 0};
+    s21_luf_t lu = {{NULL, 0, 0, 0}, NULL, 0, 0};
+    X->matrix = NULL;
+
+    if (matrix_is_empty(A) || matrix_is_empty(B)) {
+        ret = 1;
+    } else if (A->rows != A->columns || B->rows != A->rows) {
+        ret = 2;
+    } else if ((a = oriented_data(A, 0, &ta)) == NULL || (b = oriented_data(B, 0, &tb)) == NULL ||
+               (r = scratch_alloc((size_t)n * m)) == NULL ||
+               (r32 = (float *)malloc(sizeof(float) * n * m)) == NULL || s21_matrix_to_float(A, &af) != 0 ||
+               s21_create_matrix(n, m, X) != 0) {
+        ret = 2;
+    } else {
+        size_t size = (size_t)n * m;
+        double *x = X->matrix[0], a_norm = 0;
+        for (int y = 0; y < n; y++) {
+            double row = 0;
+            for (int k = 0; k < n; k++)
+                row += fabs(a[(size_t)y * n + k]);
+            a_norm = row > a_norm ? row : a_norm;
+        }
+
+        // X = 0, поэтому первая невязка - B.
+        memcpy(r, b, size * sizeof(double));
+        int ok = s21_lu_factorf(&af, &lu) == 0 && !s21_lu_singularf(&lu);
+        for (; ok && !done && steps < MIXED_ITERATIONS; steps++) {
+            for (size_t i = 0; i < size; i++)
+                r32[i] = (float)r[i];
+            // Без памяти под невязку или поправку уточнение прекращается, решает double.
+            ok = lu_substitutef(&lu, r32, m) == 0;
+            for (size_t i = 0; i < size && ok; i++)
+                x[i] += r32[i];
+            memcpy(r, b, size * sizeof(double));
+            ok = ok && gemm_blocked(n, m, n, -1, a, n, 1, x, m, 1, r, m) == 0 && isfinite(norm_max(x, size));
+            done = ok && norm_max(r, size) <= norm_max(x, size) * a_norm * DBL_EPSILON * sqrt(n);
+        }
+    }
+
+    if (ret == 0 && !done) {
+        s21_lu_t dlu;
+        s21_remove_matrix(X);
+        ret = s21_lu_factor(A, &dlu) != 0 || s21_lu_solve(&dlu, B, X) != 0 ? 2 : 0;
+        s21_lu_free(&dlu);
+        steps = -1;
+    }
+    if (iterations != NULL)
+        *iterations = ret == 0 ? steps : 0;
+    scratch_free(ta);
+    scratch_free(tb);
+    scratch_free(r);
+    free(r32);
+    s21_remove_matrixf(&af);
+    s21_lu_freef(&lu);
+
+    return ret;
+}
+
+static double norm_max(const double *a, size_t size) {
+    double norm = 0;
+
+    for (size_t i = 0; i < size; i++)
+        norm = fabs(a[i]) > norm || a[i] != a[i] ? fabs(a[i]) : norm;
+
+    return norm;
+}
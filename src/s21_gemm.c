@@ -0,0 +1,144 @@
+#include "s21_matrix.h"
+
+// Размеры блоков: MC x KC панель A, KC x NC панель B, MR x NR регистровый тайл.
+#ifndef GEMM_MC
+#define GEMM_MC 96
+#endif
+#ifndef GEMM_KC
+#define GEMM_KC 256
+#endif
+#ifndef GEMM_NC
+#define GEMM_NC 2048
+#endif
+#ifndef GEMM_MR
+#define GEMM_MR 4
+#endif
+#ifndef GEMM_NR
+#define GEMM_NR 4
+#endif
+
+// Умножения меньше этого числа FLOP считаются в вызывающем потоке.
+#ifndef GEMM_PARALLEL_MIN
+#define GEMM_PARALLEL_MIN (1L << 22)
+#endif
+
+typedef struct gemm_job {
+    int m, n, k;
+    double alpha;
+    const double *A;
+    int rsa, csa;
+    const double *B;
+    int rsb, csb;
+    double *C;
+    int ldc;
+    int tile_m, tile_n, tiles_n;
+} gemm_job_t;
+
+static int gemm_serial(int m, int n, int k, double alpha, const double *A, int rsa, int csa,
+                       const double *B, int rsb, int csb, double *C, int ldc);
+static int gemm_task(void *arg, int task);
+static void pack_a(int mc, int kc, const double *A, int rsa, int csa, double *Ap);
+static void pack_b(int kc, int nc, const double *B, int rsb, int csb, double *Bp);
+static void micro_kernel(int kc, double alpha, const double *Ap, const double *Bp, double *C, int ldc,
+                         int mr, int nr);
+
+int gemm_blocked(int m, int n, int k, double alpha, const double *A, int rsa, int csa,
+                 const double *B, int rsb, int csb, double *C, int ldc) {
+    int ret = 0;
+    int threads = s21_get_num_threads();
+
+    if (threads <= 1 || 2.0 * m * n * k < GEMM_PARALLEL_MIN) {
+        ret = gemm_serial(m, n, k, alpha, A, rsa, csa, B, rsb, csb, C, ldc);
+    } else {
+        // Тайлы C по MC строк; если их мало для всех потоков, делим и по столбцам.
+        gemm_job_t job = {m, n, k, alpha, A, rsa, csa, B, rsb, csb, C, ldc, GEMM_MC, n, 1};
+        int tiles_m = (m + GEMM_MC - 1) / GEMM_MC;
+        while (tiles_m * job.tiles_n < 4 * threads && job.tile_n >= 8 * GEMM_NR) {
+            job.tiles_n *= 2;
+            job.tile_n = ((n + job.tiles_n - 1) / job.tiles_n + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+            job.tiles_n = (n + job.tile_n - 1) / job.tile_n;
+        }
+        ret = parallel_for(tiles_m * job.tiles_n, gemm_task, &job);
+    }
+
+    return ret;
+}
+
+static int gemm_task(void *arg, int task) {
+    gemm_job_t *job = (gemm_job_t *)arg;
+    int i = task / job->tiles_n * job->tile_m;
+    int j = task % job->tiles_n * job->tile_n;
+    int m = job->m - i < job->tile_m ? job->m - i : job->tile_m;
+    int n = job->n - j < job->tile_n ? job->n - j : job->tile_n;
+
+    return gemm_serial(m, n, job->k, job->alpha, job->A + (size_t)i * job->rsa, job->rsa, job->csa,
+                       job->B + (size_t)j * job->csb, job->rsb, job->csb,
+                       job->C + (size_t)i * job->ldc + j, job->ldc);
+}
+
+static int gemm_serial(int m, int n, int k, double alpha, const double *A, int rsa, int csa,
+                       const double *B, int rsb, int csb, double *C, int ldc) {
+    int ret = 0;
+    // Буферы упаковки берутся из пула потока и не выделяются заново на каждое умножение.
+    double *Ap = scratch_alloc((size_t)GEMM_MC * GEMM_KC);
+    double *Bp = scratch_alloc((size_t)GEMM_KC * (GEMM_NC + GEMM_NR));
+
+    if (Ap == NULL || Bp == NULL) {
+        ret = 2;
+    } else {
+        for (int jc = 0; jc < n; jc += GEMM_NC) {
+            int nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+            for (int pc = 0; pc < k; pc += GEMM_KC) {
+                int kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+                pack_b(kc, nc, B + (size_t)pc * rsb + (size_t)jc * csb, rsb, csb, Bp);
+                for (int ic = 0; ic < m; ic += GEMM_MC) {
+                    int mc = m - ic < GEMM_MC ? m - ic : GEMM_MC;
+                    pack_a(mc, kc, A + (size_t)ic * rsa + (size_t)pc * csa, rsa, csa, Ap);
+                    for (int jr = 0; jr < nc; jr += GEMM_NR)
+                        for (int ir = 0; ir < mc; ir += GEMM_MR)
+                            micro_kernel(kc, alpha, Ap + (size_t)ir * kc, Bp + (size_t)jr * kc,
+                                         C + (size_t)(ic + ir) * ldc + jc + jr, ldc,
+                                         mc - ir < GEMM_MR ? mc - ir : GEMM_MR,
+                                         nc - jr < GEMM_NR ? nc - jr : GEMM_NR);
+                }
+            }
+        }
+    }
+    scratch_free(Ap);
+    scratch_free(Bp);
+
+    return ret;
+}
+
+// Полосы по MR строк: элементы столбца полосы лежат подряд, хвост дополняется нулями.
+static void pack_a(int mc, int kc, const double *A, int rsa, int csa, double *Ap) {
+    for (int i = 0; i < mc; i += GEMM_MR)
+        for (int p = 0; p < kc; p++)
+            for (int ii = 0; ii < GEMM_MR; ii++)
+                *Ap++ = i + ii < mc ? A[(size_t)(i + ii) * rsa + (size_t)p * csa] : 0;
+}
+
+// Полосы по NR столбцов: элементы строки полосы лежат подряд, хвост дополняется нулями.
+static void pack_b(int kc, int nc, const double *B, int rsb, int csb, double *Bp) {
+    for (int j = 0; j < nc; j += GEMM_NR)
+        for (int p = 0; p < kc; p++)
+            for (int jj = 0; jj < GEMM_NR; jj++)
+                *Bp++ = j + jj < nc ? B[(size_t)p * rsb + (size_t)(j + jj) * csb] : 0;
+}
+
+static void micro_kernel(int kc, double alpha, const double *Ap, const double *Bp, double *C, int ldc,
+                         int mr, int nr) {
+    double acc[GEMM_MR][GEMM_NR] = {{0}};
+
+    // Полная развёртка тайла, чтобы аккумуляторы жили в регистрах.
+    for (int p = 0; p < kc; p++, Ap += GEMM_MR, Bp += GEMM_NR)
+#pragma GCC unroll 16
+        for (int i = 0; i < GEMM_MR; i++)
+#pragma GCC unroll 16
+            for (int j = 0; j < GEMM_NR; j++)
+                acc[i][j] += Ap[i] * Bp[j];
+
+    for (int i = 0; i < mr; i++)
+        for (int j = 0; j < nr; j++)
+            C[(size_t)i * ldc + j] += alpha * acc[i][j];
+}
@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "s21_matrix.h"
+
+#define FILE_MAGIC      "S21MATRX"
+#define FILE_VERSION    1
+#define FILE_BYTE_ORDER 0x01020304u
+// Данные идут сразу за заголовком и выровнены так же, как в matrix_t.
+#define FILE_OFFSET     64
+
+// Все поля в порядке байтов записавшей машины, он определяется по byte_order.
+typedef struct matrix_file_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t dtype;
+    uint32_t alignment;
+    uint64_t rows;
+    uint64_t columns;
+    uint64_t offset;
+    char     reserved[16];
+} matrix_file_header_t;
+
+_Static_assert(sizeof(matrix_file_header_t) == FILE_OFFSET, "header must fill the payload offset");
+
+static int header_read(matrix_file_header_t *h, size_t file_size, int *swapped);
+
+int s21_save_matrix(matrix_t *A, const char *path) {
+    int ret = 0;
+    FILE *f = NULL;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else if (path == NULL || (f = fopen(path, "wb")) == NULL) {
+        ret = 2;
+    } else {
+        matrix_file_header_t h = {FILE_MAGIC, FILE_VERSION, FILE_BYTE_ORDER, S21_DTYPE_F64, MATRIX_ALIGN,
+                                  (uint64_t)A->rows, (uint64_t)A->columns, FILE_OFFSET, {0}};
+        size_t count = (size_t)A->rows * A->columns;
+        // Транспонированная матрица пишется в логическом порядке строк через временный буфер.
+        double *tmp = NULL;
+        const double *data = oriented_data(A, 0, &tmp);
+        if (data == NULL || fwrite(&h, sizeof(h), 1, f) != 1 ||
+            fwrite(data, sizeof(double), count, f) != count)
+            ret = 2;
+        scratch_free(tmp);
+        if (fclose(f) != 0)
+            ret = 2;
+    }
+
+    return ret;
+}
+
+// Файл другого порядка байтов читается с перестановкой байтов каждого элемента.
+int s21_load_matrix(const char *path, matrix_t *result) {
+    int ret = 0, swapped = 0;
+    FILE *f = NULL;
+    struct stat st;
+    matrix_file_header_t h;
+    result->matrix = NULL;
+    result->rows = 0;
+    result->columns = 0;
+    result->flags = 0;
+
+    if (path == NULL || (f = fopen(path, "rb")) == NULL) {
+        ret = 2;
+    } else if (fstat(fileno(f), &st) != 0 || fread(&h, sizeof(h), 1, f) != 1 ||
+               header_read(&h, (size_t)st.st_size, &swapped) != 0) {
+        ret = 2;
+    } else if (s21_create_matrix((int)h.rows, (int)h.columns, result) != 0) {
+        ret = 2;
+    } else {
+        size_t count = (size_t)h.rows * h.columns;
+        uint64_t *data = (uint64_t *)result->matrix[0];
+        if (fseek(f, (long)h.offset, SEEK_SET) != 0 || fread(data, sizeof(double), count, f) != count)
+            ret = 2;
+        for (size_t i = 0; i < count && swapped && ret == 0; i++)
+            data[i] = __builtin_bswap64(data[i]);
+        if (ret != 0)
+            s21_remove_matrix(result);
+    }
+    if (f != NULL)
+        fclose(f);
+
+    return ret;
+}
+
+/*
+ * Данные не копируются: строки matrix_t указывают прямо в отображение файла, страницы
+ * читаются по мере обращения и делятся с другими процессами через кэш страниц.
+ * Отображение частное: файл открыт только на чтение, а запись в такую матрицу (s21_*_inplace,
+ * s21_transpose_inplace) копирует затронутые страницы в память процесса и не меняет файл.
+ * Нужен родной порядок байтов; s21_remove_matrix снимает отображение.
+ */
+int s21_mmap_matrix(const char *path, matrix_t *result) {
+    int ret = 0, swapped = 0, fd = -1;
+    struct stat st;
+    void *map = MAP_FAILED;
+    result->matrix = NULL;
+    result->rows = 0;
+    result->columns = 0;
+    result->flags = 0;
+
+    if (path == NULL || (fd = open(path, O_RDONLY)) < 0 || fstat(fd, &st) != 0 ||
+        (size_t)st.st_size < sizeof(matrix_file_header_t)) {
+        ret = 2;
+    } else if ((map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)) ==
+               MAP_FAILED) {
+        ret = 2;
+    } else {
+        matrix_file_header_t h = *(const matrix_file_header_t *)map;
+        if (header_read(&h, (size_t)st.st_size, &swapped) != 0 || swapped ||
+            matrix_map(map, (size_t)st.st_size, h.offset, (int)h.rows, (int)h.columns, result) != 0) {
+            ret = 2;
+            munmap(map, (size_t)st.st_size);
+            result->matrix = NULL;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+
+    return ret;
+}
+
+// Проверяет заголовок и размер файла; поля чужого порядка байтов переставляются на месте.
+static int header_read(matrix_file_header_t *h, size_t file_size, int *swapped) {
+    int ret = 0;
+
+    *swapped = h->byte_order == __builtin_bswap32(FILE_BYTE_ORDER);
+    if (*swapped) {
+        h->version = __builtin_bswap32(h->version);
+        h->dtype = __builtin_bswap32(h->dtype);
+        h->alignment = __builtin_bswap32(h->alignment);
+        h->rows = __builtin_bswap64(h->rows);
+        h->columns = __builtin_bswap64(h->columns);
+        h->offset = __builtin_bswap64(h->offset);
+    }
+
+    if (memcmp(h->magic, FILE_MAGIC, sizeof(h->magic)) != 0 || h->version != FILE_VERSION ||
+        (h->byte_order != FILE_BYTE_ORDER && !*swapped) || h->dtype != S21_DTYPE_F64) {
+        ret = 2;
+    } else if (h->rows < 1 || h->columns < 1 || h->rows > INT_MAX || h->columns > INT_MAX ||
+               h->offset < sizeof(*h) || h->offset % sizeof(double) != 0) {
+        ret = 2;
+    } else if (h->offset > file_size || (file_size - h->offset) / sizeof(double) / h->rows < h->columns) {
+        ret = 2;
+    }
+
+    return ret;
+}
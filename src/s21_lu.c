@@ -0,0 +1,86 @@
+#include "s21_matrix.h"
+
+// Раскладка блока матрицы и LU-разложение для double и float: s21_real_kernels.h
+// подключается по разу на тип элемента.
+
+// Высота блока строк при решении: внедиагональные блоки считаются одним умножением.
+#ifndef LU_SOLVE_NB
+#define LU_SOLVE_NB 64
+#endif
+
+// Для float нет упакованного gemm_blocked: блок обновляется построчно через vec_axpyf.
+static int gemm_subf(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C,
+                     int ldc);
+static void scalef(float *r, const float *a, float s, size_t n);
+
+#define REAL double
+#define MATRIX matrix_t
+#define REAL_LU s21_lu_t
+#define NAME(name) s21_##name
+#define REAL_FN(name) name
+#define REAL_EPS EPS
+#define REAL_EMPTY(A) matrix_is_empty(A)
+#define REAL_LOAD(A, buf) matrix_to_buffer(A, buf)
+#define REAL_AXPY vec_axpy
+#define REAL_SCALE vec_scale
+#define REAL_GEMM_SUB(m, n, k, A, lda, B, ldb, C, ldc) gemm_blocked(m, n, k, -1, A, lda, 1, B, ldb, 1, C, ldc)
+#define REAL_STATS_BEGIN() STATS_BEGIN()
+#define REAL_STATS_END(name, flops) STATS_END(name, flops)
+#include "s21_real_kernels.h"
+#undef REAL
+#undef MATRIX
+#undef REAL_LU
+#undef NAME
+#undef REAL_FN
+#undef REAL_EPS
+#undef REAL_EMPTY
+#undef REAL_LOAD
+#undef REAL_AXPY
+#undef REAL_SCALE
+#undef REAL_GEMM_SUB
+#undef REAL_STATS_BEGIN
+#undef REAL_STATS_END
+
+// Счётчики s21_stats_snapshot ведутся только для double.
+#define REAL float
+#define MATRIX matrixf_t
+#define REAL_LU s21_luf_t
+#define NAME(name) s21_##name##f
+#define REAL_FN(name) name##f
+#define REAL_EPS EPSF
+#define REAL_EMPTY(A) ((A)->matrix == NULL)
+#define REAL_LOAD(A, buf) memcpy(buf, (A)->matrix[0], sizeof(float) * (A)->rows * (A)->columns)
+#define REAL_AXPY vec_axpyf
+#define REAL_SCALE scalef
+#define REAL_GEMM_SUB gemm_subf
+#define REAL_STATS_BEGIN() ((void)0)
+#define REAL_STATS_END(name, flops) ((void)0)
+#include "s21_real_kernels.h"
+#undef REAL
+#undef MATRIX
+#undef REAL_LU
+#undef NAME
+#undef REAL_FN
+#undef REAL_EPS
+#undef REAL_EMPTY
+#undef REAL_LOAD
+#undef REAL_AXPY
+#undef REAL_SCALE
+#undef REAL_GEMM_SUB
+#undef REAL_STATS_BEGIN
+#undef REAL_STATS_END
+
+static int gemm_subf(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C,
+                     int ldc) {
+    for (int y = 0; y < m; y++)
+        for (int p = 0; p < k; p++)
+            if (A[(size_t)y * lda + p] != 0)
+                vec_axpyf(C + (size_t)y * ldc, B + (size_t)p * ldb, -A[(size_t)y * lda + p], (size_t)n);
+
+    return 0;
+}
+
+static void scalef(float *r, const float *a, float s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        r[i] = a[i] * s;
+}
@@ -1,68 +1,95 @@
 #include "s21_matrix.h"
 
+static int elementwise(vec_op_fn op, matrix_t *A, matrix_t *B, matrix_t *result);
+static int elementwise_inplace(vec_op_fn op, matrix_t *A, matrix_t *B);
+static int eq_storage(matrix_t *A, matrix_t *B, int mode, double tolerance);
+static int inverse_compute(matrix_t *A, matrix_t *result);
+
+// Кусок, который сначала сравнивается побитово (memcmp) и только при отличии - с допуском.
+#define EQ_CHUNK 4096
+// Режим eq_storage для s21_eq_matrix: прежнее ядро vec_eq, неравны только при |a - b| > EPS.
+#define EQ_LEGACY (-1)
+
 int s21_create_matrix(int rows, int columns, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
     result->rows = rows;
     result->columns = columns;
+    result->flags = 0;
 
     if (rows < 1 || columns < 1) {
         ret = 1;
         result->matrix = NULL;
     } else {
-        result->matrix = (double **)calloc(rows, sizeof(double *));
+        // Один блок: заголовок, массив указателей на строки, выровненные на MATRIX_ALIGN данные.
+        size_t bytes = matrix_bytes(rows, columns);
+        void *mem = bytes > 0 ? matrix_block_alloc(bytes) : NULL;
 
-        if (result->matrix == NULL) {
+        if (mem == NULL) {
             ret = 2;
+            result->matrix = NULL;
+            result->rows = 0;
+            result->columns = 0;
         } else {
-            for (int i = 0; i < rows && !ret; i++) {
-                result->matrix[i] = (double *)calloc(columns, sizeof(double));
-                if (result->matrix[i] == NULL) {
-                    ret = 2;
-                    for (int j = 0; j < i; j++)
-                        free(result->matrix[j]);
-                    free(result->matrix);
-                }
-            }
-
-            for (int y = 0; y < result->rows; y++)
-                for (int x = 0; x < result->columns; x++)
-                    result->matrix[y][x] = 0;
+            matrix_layout(mem, rows, columns, result);
+            STATS_LIVE(1);
         }
     }
 
+    STATS_END(create_matrix, 0);
     return ret;
 }
 
 void s21_remove_matrix(matrix_t *A) {
-    if (!matrix_is_empty(A)) {
-        for (int i = 0; i < A->rows; i++)
-            if (A->matrix[i])
-                free(A->matrix[i]);
-        if (A->matrix)
-            free(A->matrix);
+    STATS_BEGIN();
+    // Блок возвращается владельцу: в кучу, в пул; матрицы арены освобождает сама арена.
+    if (!matrix_is_empty(A) && !(A->flags & S21_BORROWED)) {
+        matrix_block_release(A->matrix);
+        STATS_LIVE(-1);
     }
-    if (A->columns)
-        A->columns = 0;
-    if (A->rows)
-        A->rows = 0;
+    A->matrix = NULL;
+    A->columns = 0;
+    A->rows = 0;
+    A->flags = 0;
+    STATS_END(remove_matrix, 0);
 }
 
 int s21_eq_matrix(matrix_t *A, matrix_t *B) {
+    STATS_BEGIN();
     int ret = 1;
 
     if (matrix_is_empty(A) || matrix_is_empty(B) || A->columns != B->columns || A->rows != B->rows) {
         ret = 0;
     } else {
-        for (int y = 0; (y < A->rows) && ret; y++)
-            for (int x = 0; (x < A->columns) && ret; x++)
-                if (fabs(A->matrix[y][x] - B->matrix[y][x]) > EPS)
-                    ret = 0;
+        ret = eq_storage(A, B, EQ_LEGACY, EPS);
+    }
+
+    STATS_END(eq_matrix, ret ? (double)A->rows * A->columns : 0);
+    return ret;
+}
+
+/*
+ * Как s21_eq_matrix, но с режимом S21_EQ_ABS, S21_EQ_REL или S21_EQ_ULP. Побитово равные
+ * элементы равны в любом режиме, в остальных случаях NaN равен только NaN. Неизвестный
+ * режим или отрицательный допуск - FAILURE, у допуска ULP дробная часть отбрасывается.
+ */
+int s21_eq_matrix_tol(matrix_t *A, matrix_t *B, int mode, double tolerance) {
+    STATS_BEGIN();
+    int ret = 1;
+
+    if (matrix_is_empty(A) || matrix_is_empty(B) || A->columns != B->columns || A->rows != B->rows ||
+        mode < S21_EQ_ABS || mode > S21_EQ_ULP || !(tolerance >= 0)) {
+        ret = 0;
+    } else {
+        ret = eq_storage(A, B, mode, tolerance);
     }
 
+    STATS_END(eq_matrix_tol, ret ? (double)A->rows * A->columns : 0);
     return ret;
 }
 
 int s21_sum_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A) || matrix_is_empty(B)) {
@@ -70,16 +97,15 @@ int s21_sum_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
     } else if (A->rows != B->rows || A->columns != B->columns) {
         ret = 2;
     } else {
-        s21_create_matrix(A->rows, A->columns, result);
-        for (int y = 0; y < A->rows; y++)
-            for (int x = 0; x < A->columns; x++)
-                result->matrix[y][x] = A->matrix[y][x] + B->matrix[y][x];
+        ret = elementwise(vec_add, A, B, result);
     }
 
+    STATS_END(sum_matrix, ret ? 0 : (double)A->rows * A->columns);
     return ret;
 }
 
 int s21_sub_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A) || matrix_is_empty(B)) {
@@ -87,32 +113,32 @@ int s21_sub_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
     } else if (A->rows != B->rows || A->columns != B->columns) {
         ret = 2;
     } else {
-        s21_create_matrix(A->rows, A->columns, result);
-        for (int y = 0; y < A->rows; y++)
-            for (int x = 0; x < A->columns; x++)
-                result->matrix[y][x] = A->matrix[y][x] - B->matrix[y][x];
+        ret = elementwise(vec_sub, A, B, result);
     }
 
+    STATS_END(sub_matrix, ret ? 0 : (double)A->rows * A->columns);
     return ret;
 }
 
 int s21_mult_number(matrix_t *A, double number, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A)) {
         ret = 1;
+    } else if (s21_create_matrix(A->rows, A->columns, result) != 0) {
+        ret = 2;
     } else {
-        s21_create_matrix(A->rows, A->columns, result);
-
-        for (int y = 0; y < A->rows; y++)
-            for (int x = 0; x < A->columns; x++)
-                result->matrix[y][x] = A->matrix[y][x] * number;
+        matrix_to_buffer(A, result->matrix[0]);
+        vec_scale(result->matrix[0], result->matrix[0], number, (size_t)A->rows * A->columns);
     }
 
+    STATS_END(mult_number, ret ? 0 : (double)A->rows * A->columns);
     return ret;
 }
 
 int s21_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A) || matrix_is_empty(B)) {
@@ -120,33 +146,50 @@ int s21_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
     } else if (A->columns != B->rows) {
         ret = 2;
     } else {
-        s21_create_matrix(B->columns, A->rows, result);
-        for (int y = 0; y < result->rows; y++)
-            for (int x = 0; x < result->columns; x++)
-                for (int n = 0; n < A->columns; n++)
-                    result->matrix[y][x] += (A->matrix[y][n] * B->matrix[n][x]);
+        // Блочное умножение с упаковкой панелей A и B, см. s21_gemm.c.
+        // Транспонированные A и B читаются при упаковке через шаги, без копии.
+        int rsa, csa, rsb, csb;
+        matrix_strides(A, &rsa, &csa);
+        matrix_strides(B, &rsb, &csb);
+        if (s21_create_matrix(A->rows, B->columns, result) != 0) {
+            ret = 2;
+        } else if (FIXED_SIZE(A) && FIXED_SIZE(B) && A->rows == B->rows) {
+            fixed_mult(A, B, result);
+        } else {
+            if (strassen_applies(A->rows, B->columns, A->columns))
+                ret = strassen_mult(A, B, result);
+            else
+                ret = gemm_blocked(A->rows, B->columns, A->columns, 1, A->matrix[0], rsa, csa,
+                                   B->matrix[0], rsb, csb, result->matrix[0], result->columns);
+            if (ret != 0)
+                s21_remove_matrix(result);
+        }
     }
 
+    STATS_END(mult_matrix, ret ? 0 : 2.0 * A->rows * A->columns * B->columns);
     return ret;
 }
 
 int s21_transpose(matrix_t *A, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A)) {
         ret = 1;
+    } else if (s21_create_matrix(A->columns, A->rows, result) != 0) {
+        ret = 2;
+    } else if (matrix_is_transposed(A)) {
+        memcpy(result->matrix[0], A->matrix[0], sizeof(double) * A->rows * A->columns);
     } else {
-        s21_create_matrix(A->columns, A->rows, result);
-
-        for (int y = 0; y < A->rows; y++)
-            for (int x = 0; x < A->columns; x++)
-                    result->matrix[x][y] = A->matrix[y][x];
+        transpose_blocked(A->matrix[0], A->rows, A->columns, result->matrix[0]);
     }
 
+    STATS_END(transpose, 0);
     return ret;
 }
 
 int s21_calc_complements(matrix_t *A, matrix_t *result) {
+    STATS_BEGIN();
     int ret = 0;
 
     if (matrix_is_empty(A)) {
@@ -154,101 +197,525 @@ int s21_calc_complements(matrix_t *A, matrix_t *result) {
     } else if (A->rows != A->columns) {
         ret = 2;
     } else {
-        matrix_t M;
         double minor_det = 0;
 
-        s21_create_matrix(A->rows, A->columns, result);
-
-        for (int y = 0; y < A->rows; y++)
-            for (int x = 0; x < A->columns; x++) {
-                get_minor(A, &M, y, x);
-                s21_determinant(&M, &minor_det);
-                s21_remove_matrix(&M);
-                result->matrix[y][x] = minor_det * pow(-1, y+x);
-            }
+        if (s21_create_matrix(A->rows, A->columns, result) != 0) {
+            ret = 2;
+        } else if (A->rows == 1) {
+            // Минор 0 x 0 равен 1: так adj(A) * A = det(A) * E выполняется и для n = 1.
+            result->matrix[0][0] = 1;
+        } else if (A->rows > 3) {
+            // Присоединённая матрица через LU с полным выбором, O(n^3), в том числе для вырожденных A.
+            double *buf = copy_to_buffer(A);
+            ret = buf == NULL ? 2 : lu_complements(buf, A->rows, result);
+            scratch_free(buf);
+        } else {
+            // Миноры читаются из A через представление, без копирования в отдельные матрицы.
+            for (int y = 0; y < A->rows && !ret; y++)
+                for (int x = 0; x < A->columns && !ret; x++) {
+                    matrix_view_t M;
+                    s21_minor_view(A, y, x, &M);
+                    ret = s21_view_determinant(&M, &minor_det);
+                    result->matrix[y][x] = (y + x) % 2 ? -minor_det : minor_det;
+                }
+        }
+        if (ret != 0)
+            s21_remove_matrix(result);
     }
 
+    STATS_END(calc_complements, ret ? 0 : 2.0 * A->rows * A->rows * A->rows);
     return ret;
 }
 
 int s21_determinant(matrix_t *A, double *result) {
-    int ret = 0;
+    STATS_BEGIN();
+    int ret = 0, hit = 0;
+    cache_key_t key;
 
     if (matrix_is_empty(A)) {
         ret = 1;
     } else if (A->rows != A->columns) {
         ret = 2;
-    } else if (A->rows == 1) {
-        *result = A->matrix[0][0];
-    } else if (A->rows == 2) {
-        *result = (A->matrix[0][0] * A->matrix[1][1]) - (A->matrix[1][0] *  A->matrix[0][1]);
-    } else {
-        matrix_t M;
-        double minor_det = 0;
-        *result = 0;
-
-        for (int x = 0; x < A->columns; x++) {
-            // Идём по первой строке, четвёртый параметр - вычёркиваемый столбец.
-            get_minor(A, &M, 0, x);
-            s21_determinant(&M, &minor_det);
-            s21_remove_matrix(&M);
-            if (x % 2 == 0)
-                *result += (A->matrix[0][x] * minor_det);
-            else
-                *result -= (A->matrix[0][x] * minor_det);
-        }
+    } else if (FIXED_SIZE(A)) {
+        *result = fixed_determinant(A);
+    } else if ((hit = (cache_lookup(S21_CACHE_DETERMINANT, A, &key, result, NULL) == 0)) == 0) {
+        matrix_view_t view;
+        s21_matrix_view(A, &view);
+        ret = s21_view_determinant(&view, result);
+        if (ret == 0)
+            cache_store(&key, A, *result, NULL);
     }
 
+    // Попадание в кэш - хеширование и сравнение n^2 элементов, а не разложение.
+    STATS_END(determinant, ret ? 0 : hit ? (double)A->rows * A->rows : 2.0 / 3 * A->rows * A->rows * A->rows);
     return ret;
 }
 
 int s21_inverse_matrix(matrix_t *A, matrix_t *result) {
-    int ret = 0;
+    STATS_BEGIN();
+    int ret = 0, hit = 0;
+    cache_key_t key;
     result->rows = 0;
     result->columns = 0;
 
     if (matrix_is_empty(A)) {
         ret = 1;
+    } else if (A->rows != A->columns) {
+        ret = 2;
+    } else if ((hit = (cache_lookup(S21_CACHE_INVERSE, A, &key, NULL, result) == 0)) == 0) {
+        ret = inverse_compute(A, result);
+        if (ret == 0)
+            cache_store(&key, A, 0, result);
+    }
+
+    STATS_END(inverse_matrix, ret ? 0 : hit ? (double)A->rows * A->rows : 2.0 * A->rows * A->rows * A->rows);
+    return ret;
+}
+
+int s21_sum_matrix_inplace(matrix_t *A, matrix_t *B) {
+    STATS_BEGIN();
+    int ret = elementwise_inplace(vec_add, A, B);
+
+    STATS_END(sum_matrix_inplace, ret ? 0 : (double)A->rows * A->columns);
+    return ret;
+}
+
+int s21_sub_matrix_inplace(matrix_t *A, matrix_t *B) {
+    STATS_BEGIN();
+    int ret = elementwise_inplace(vec_sub, A, B);
+
+    STATS_END(sub_matrix_inplace, ret ? 0 : (double)A->rows * A->columns);
+    return ret;
+}
+
+int s21_mult_number_inplace(matrix_t *A, double number) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else {
+        vec_scale(A->matrix[0], A->matrix[0], number, (size_t)A->rows * A->columns);
+    }
+
+    STATS_END(mult_number_inplace, ret ? 0 : (double)A->rows * A->columns);
+    return ret;
+}
+
+int s21_axpy(double alpha, matrix_t *X, matrix_t *Y) {
+    STATS_BEGIN();
+    int ret = check_same_size(X, Y);
+    double *tmp = NULL;
+    const double *x = ret == 0 ? oriented_data(X, matrix_is_transposed(Y), &tmp) : NULL;
+
+    if (ret == 0 && x == NULL)
+        ret = 2;
+    else if (ret == 0)
+        vec_axpy(Y->matrix[0], x, alpha, (size_t)X->rows * X->columns);
+    scratch_free(tmp);
+
+    STATS_END(axpy, ret ? 0 : 2.0 * X->rows * X->columns);
+    return ret;
+}
+
+int s21_gemm(double alpha, matrix_t *A, matrix_t *B, double beta, matrix_t *C) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (matrix_is_empty(A) || matrix_is_empty(B) || matrix_is_empty(C)) {
+        ret = 1;
+    } else if (A->columns != B->rows || C->rows != A->rows || C->columns != B->columns) {
+        ret = 2;
+    } else if (C->matrix[0] == A->matrix[0] || C->matrix[0] == B->matrix[0] || matrix_is_transposed(C)) {
+        // C перезаписывается по ходу умножения, поэтому не может совпадать с A или B.
+        ret = 2;
     } else {
-        double A_det = 0;
-        if (s21_determinant(A, &A_det) != 0 || A_det == 0) {
+        int rsa, csa, rsb, csb;
+        matrix_strides(A, &rsa, &csa);
+        matrix_strides(B, &rsb, &csb);
+        size_t size = (size_t)C->rows * C->columns;
+        // При beta == 0 старое содержимое C не читается, как в BLAS.
+        if (beta == 0)
+            memset(C->matrix[0], 0, size * sizeof(double));
+        else if (beta != 1)
+            vec_scale(C->matrix[0], C->matrix[0], beta, size);
+        if (alpha != 0)
+            ret = gemm_blocked(A->rows, B->columns, A->columns, alpha, A->matrix[0], rsa, csa,
+                               B->matrix[0], rsb, csb, C->matrix[0], C->columns);
+    }
+
+    STATS_END(gemm, ret ? 0 : 2.0 * A->rows * A->columns * B->columns);
+    return ret;
+}
+
+// result = A op B; транспонированные операнды приводятся к обычной ориентации.
+static int elementwise(vec_op_fn op, matrix_t *A, matrix_t *B, matrix_t *result) {
+    int ret = 0;
+    double *ta = NULL, *tb = NULL;
+    const double *a = oriented_data(A, 0, &ta);
+    const double *b = oriented_data(B, 0, &tb);
+
+    if (a == NULL || b == NULL || s21_create_matrix(A->rows, A->columns, result) != 0)
+        ret = 2;
+    else
+        op(result->matrix[0], a, b, (size_t)A->rows * A->columns);
+    scratch_free(ta);
+    scratch_free(tb);
+
+    return ret;
+}
+
+/*
+ * Хранилища сравниваются в ориентации A, B при несовпадении транспонируется во временный буфер.
+ * Одно и то же хранилище равно себе без чтения. Иначе каждый кусок сначала проверяется memcmp:
+ * одинаковые данные (частый случай при проверке кэша) читаются со скоростью памяти, а
+ * отличающийся кусок проверяется с допуском, пока он ещё в кэше.
+ */
+static int eq_storage(matrix_t *A, matrix_t *B, int mode, double tolerance) {
+    int ret = 1;
+    size_t size = (size_t)A->rows * A->columns;
+    double *tmp = NULL;
+    const double *a = A->matrix[0], *b = NULL;
+    int64_t ulps = (int64_t)fmin(tolerance, S21_EQ_MAX_ULP);
+
+    if (A->matrix[0] == B->matrix[0] && matrix_is_transposed(A) == matrix_is_transposed(B)) {
+        ret = 1;
+    } else if ((b = oriented_data(B, matrix_is_transposed(A), &tmp)) == NULL) {
+        ret = 0;
+    } else {
+        for (size_t start = 0; start < size && ret; start += EQ_CHUNK) {
+            size_t n = size - start < EQ_CHUNK ? size - start : EQ_CHUNK;
+            if (memcmp(a + start, b + start, n * sizeof(double)) == 0)
+                continue;
+            if (mode == EQ_LEGACY)
+                ret = vec_eq(a + start, b + start, n, tolerance);
+            else if (mode == S21_EQ_ABS)
+                ret = vec_eq_abs(a + start, b + start, n, tolerance);
+            else if (mode == S21_EQ_REL)
+                ret = vec_eq_rel(a + start, b + start, n, tolerance);
+            else
+                ret = vec_eq_ulp(a + start, b + start, n, ulps);
+        }
+    }
+    scratch_free(tmp);
+
+    return ret;
+}
+
+static int inverse_compute(matrix_t *A, matrix_t *result) {
+    int ret = 0;
+
+    if (s21_create_matrix(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else if (!FIXED_SIZE(A) || fixed_inverse(A, result) != 0) {
+        // Метод Гаусса-Жордана: одна рабочая копия A, результат строится сразу в result.
+        // Для 2x2-4x4 сюда попадают только матрицы у границы вырожденности (см. fixed_inverse).
+        double *buf = copy_to_buffer(A);
+        ret = buf == NULL ? 2 : gauss_jordan_inverse(buf, A->rows, result);
+        if (ret != 0)
+            s21_remove_matrix(result);
+        scratch_free(buf);
+    }
+
+    return ret;
+}
+
+// A = A op B в хранилище A, B приводится к ориентации A.
+static int elementwise_inplace(vec_op_fn op, matrix_t *A, matrix_t *B) {
+    int ret = check_same_size(A, B);
+    double *tmp = NULL;
+    const double *b = ret == 0 ? oriented_data(B, matrix_is_transposed(A), &tmp) : NULL;
+
+    if (ret == 0 && b == NULL)
+        ret = 2;
+    else if (ret == 0)
+        op(A->matrix[0], A->matrix[0], b, (size_t)A->rows * A->columns);
+    scratch_free(tmp);
+
+    return ret;
+}
+
+int check_same_size(matrix_t *A, matrix_t *B) {
+    int ret = 0;
+
+    if (matrix_is_empty(A) || matrix_is_empty(B)) {
+        ret = 1;
+    } else if (A->rows != B->rows || A->columns != B->columns) {
+        ret = 2;
+    }
+
+    return ret;
+}
+
+int matrix_is_transposed(matrix_t *A) {
+    return (A->flags & S21_TRANSPOSED) != 0;
+}
+
+// Шаги между соседними элементами по строке и по столбцу с учётом S21_TRANSPOSED.
+void matrix_strides(matrix_t *A, int *row_stride, int *column_stride) {
+    if (matrix_is_transposed(A)) {
+        *row_stride = 1;
+        *column_stride = A->rows;
+    } else {
+        *row_stride = A->columns;
+        *column_stride = 1;
+    }
+}
+
+// Элементы A построчно в обычной (не транспонированной) ориентации.
+void matrix_to_buffer(matrix_t *A, double *buf) {
+    if (matrix_is_transposed(A))
+        transpose_blocked(A->matrix[0], A->columns, A->rows, buf);
+    else
+        memcpy(buf, A->matrix[0], sizeof(double) * A->rows * A->columns);
+}
+
+// Хранилище A в ориентации transposed: либо само, либо копия в *tmp (освобождать через scratch_free).
+const double *oriented_data(matrix_t *A, int transposed, double **tmp) {
+    const double *data = A->matrix[0];
+    *tmp = NULL;
+
+    if (matrix_is_transposed(A) != transposed) {
+        *tmp = scratch_alloc((size_t)A->rows * A->columns);
+        if (*tmp != NULL && transposed)
+            transpose_blocked(A->matrix[0], A->rows, A->columns, *tmp);
+        else if (*tmp != NULL)
+            transpose_blocked(A->matrix[0], A->columns, A->rows, *tmp);
+        data = *tmp;
+    }
+
+    return data;
+}
+
+// Буфер берётся из пула потока, освобождать через scratch_free.
+double *copy_to_buffer(matrix_t *A) {
+    double *buf = scratch_alloc((size_t)A->rows * A->columns);
+
+    if (buf != NULL)
+        matrix_to_buffer(A, buf);
+
+    return buf;
+}
+
+void swap_rows(double *buf, int columns, int y1, int y2) {
+    for (int x = 0; x < columns; x++) {
+        double tmp = buf[y1 * columns + x];
+        buf[y1 * columns + x] = buf[y2 * columns + x];
+        buf[y2 * columns + x] = tmp;
+    }
+}
+
+double lu_determinant(double *buf, int n) {
+    double det = 1;
+
+    for (int k = 0; k < n && det != 0; k++) {
+        int p = k;
+        for (int y = k + 1; y < n; y++)
+            if (fabs(buf[y * n + k]) > fabs(buf[p * n + k]))
+                p = y;
+
+        if (buf[p * n + k] == 0) {
+            det = 0;
+        } else {
+            if (p != k) {
+                swap_rows(buf, n, p, k);
+                det = -det;
+            }
+            det *= buf[k * n + k];
+            for (int y = k + 1; y < n; y++) {
+                double l = buf[y * n + k] / buf[k * n + k];
+                for (int x = k + 1; x < n; x++)
+                    buf[y * n + x] -= l * buf[k * n + x];
+            }
+        }
+    }
+
+    return det;
+}
+
+int gauss_jordan_inverse(double *buf, int n, matrix_t *result) {
+    int ret = 0;
+    double scale = 0;
+
+    for (int i = 0; i < n * n; i++)
+        if (fabs(buf[i]) > scale)
+            scale = fabs(buf[i]);
+    for (int y = 0; y < n; y++)
+        result->matrix[y][y] = 1;
+
+    for (int k = 0; k < n && !ret; k++) {
+        int p = k;
+        for (int y = k + 1; y < n; y++)
+            if (fabs(buf[y * n + k]) > fabs(buf[p * n + k]))
+                p = y;
+
+        // Ведущий элемент сравнивается с EPS относительно наибольшего по модулю элемента A.
+        if (scale == 0 || fabs(buf[p * n + k]) <= EPS * scale) {
             ret = 2;
         } else {
-            matrix_t R, T;
-            s21_calc_complements(A, &R);
-            s21_transpose(&R, &T);
-            s21_mult_number(&T, 1.0 / A_det, result);
-            s21_remove_matrix(&R);
-            s21_remove_matrix(&T);
+            double *rk = result->matrix[k];
+            if (p != k) {
+                swap_rows(buf, n, p, k);
+                for (int x = 0; x < n; x++) {
+                    double tmp = rk[x];
+                    rk[x] = result->matrix[p][x];
+                    result->matrix[p][x] = tmp;
+                }
+            }
+
+            double pivot = buf[k * n + k];
+            for (int x = 0; x < n; x++) {
+                buf[k * n + x] /= pivot;
+                rk[x] /= pivot;
+            }
+
+            for (int y = 0; y < n; y++) {
+                double l = buf[y * n + k];
+                if (y != k && l != 0) {
+                    double *ry = result->matrix[y];
+                    for (int x = k; x < n; x++)
+                        buf[y * n + x] -= l * buf[k * n + x];
+                    for (int x = 0; x < n; x++)
+                        ry[x] -= l * rk[x];
+                }
+            }
         }
     }
 
     return ret;
 }
 
-void get_minor(matrix_t *A, matrix_t *result, int oy, int ox) {
-    s21_create_matrix(A->rows-1, A->columns-1, result);
+/*
+ * PAQ = LDV: L и V - единичные треугольные, D - диагональ ведущих элементов.
+ * adj(A) = det(P)det(Q) * Q * V^-1 * adj(D) * L^-1 * P, где adj(D)_i - произведение
+ * всех d_j кроме d_i. Деления на малые ведущие элементы нет, поэтому формула
+ * верна и для вырожденных A (ранг n-1 даёт матрицу ранга 1, меньший ранг - нули).
+ * Результат - транспонированная adj(A), то есть матрица алгебраических дополнений.
+ */
+int lu_complements(double *a, int n, matrix_t *result) {
+    int ret = 0;
+    int *perm = (int *)malloc(sizeof(int) * 2 * n);
+    double *d = scratch_alloc((size_t)n);
+    double sign = 1;
 
-    for (int y = 0; y < A->rows; y++)
-        for (int x = 0; x < A->columns; x++) {
-            if (y == oy || x == ox)
-                continue;
-            else if (y < oy && x < ox)
-                result->matrix[y][x] = A->matrix[y][x];
-            else if (y > oy && x < ox)
-                result->matrix[y-1][x] = A->matrix[y][x];
-            else if (y < oy && x > ox)
-                result->matrix[y][x-1] = A->matrix[y][x];
-            else if (y > oy && x > ox)
-                result->matrix[y-1][x-1] = A->matrix[y][x];
+    if (perm == NULL || d == NULL) {
+        ret = 2;
+    } else {
+        int *pr = perm, *qc = perm + n;
+        sign = lu_complete_pivot(a, n, pr, qc, d);
+
+        // X = P, затем X = L^-1 * X.
+        double **X = result->matrix;
+        memset(X[0], 0, sizeof(double) * n * n);
+        for (int k = 0; k < n; k++)
+            X[k][k] = 1;
+        for (int k = 0; k < n; k++)
+            if (pr[k] != k)
+                swap_rows(X[0], n, k, pr[k]);
+        for (int y = 1; y < n; y++)
+            for (int j = 0; j < y; j++)
+                if (a[y * n + j] != 0)
+                    vec_axpy(X[y], X[j], -a[y * n + j], n);
+
+        // X = adj(D) * X, произведения через префиксы и суффиксы.
+        double prefix = 1;
+        for (int k = 0; k < n; k++) {
+            double suffix = 1;
+            for (int j = k + 1; j < n; j++)
+                suffix *= d[j];
+            vec_scale(X[k], X[k], prefix * suffix, n);
+            prefix *= d[k];
         }
+
+        // X = V^-1 * X, где V = D^-1 * U (строки с нулевым d_k тождественные).
+        for (int y = n - 1; y >= 0; y--)
+            for (int j = y + 1; j < n && d[y] != 0; j++)
+                if (a[y * n + j] != 0)
+                    vec_axpy(X[y], X[j], -a[y * n + j] / d[y], n);
+
+        // X = Q * X: перестановки столбцов в обратном порядке.
+        for (int k = n - 1; k >= 0; k--)
+            if (qc[k] != k)
+                swap_rows(X[0], n, k, qc[k]);
+
+        for (int y = 0; y < n; y++) {
+            X[y][y] *= sign;
+            for (int x = y + 1; x < n; x++) {
+                double tmp = X[y][x];
+                X[y][x] = sign * X[x][y];
+                X[x][y] = sign * tmp;
+            }
+        }
+    }
+    free(perm);
+    scratch_free(d);
+
+    return ret;
+}
+
+// LU с полным выбором ведущего элемента на месте; возвращает det(P)det(Q).
+double lu_complete_pivot(double *a, int n, int *pr, int *qc, double *d) {
+    double sign = 1;
+    int rank = n;
+
+    for (int k = 0; k < n; k++) {
+        int p = k, q = k;
+        for (int y = k; y < n && k < rank; y++)
+            for (int x = k; x < n; x++)
+                if (fabs(a[y * n + x]) > fabs(a[p * n + q])) {
+                    p = y;
+                    q = x;
+                }
+        pr[k] = p;
+        qc[k] = q;
+
+        if (k >= rank || a[p * n + q] == 0) {
+            // Оставшийся блок нулевой: ранг найден, дальше только нули в D.
+            rank = k < rank ? k : rank;
+            pr[k] = k;
+            qc[k] = k;
+            d[k] = 0;
+        } else {
+            if (p != k) {
+                swap_rows(a, n, p, k);
+                sign = -sign;
+            }
+            if (q != k) {
+                for (int y = 0; y < n; y++) {
+                    double tmp = a[y * n + k];
+                    a[y * n + k] = a[y * n + q];
+                    a[y * n + q] = tmp;
+                }
+                sign = -sign;
+            }
+            d[k] = a[k * n + k];
+            for (int y = k + 1; y < n; y++) {
+                double l = a[y * n + k] /= d[k];
+                for (int x = k + 1; x < n; x++)
+                    a[y * n + x] -= l * a[k * n + x];
+            }
+        }
+    }
+
+    return sign;
+}
+
+void get_minor(matrix_t *A, matrix_t *result, int oy, int ox) {
+    matrix_view_t view;
+
+    if (s21_minor_view(A, oy, ox, &view) != 0 || s21_view_to_matrix(&view, result) != 0) {
+        result->matrix = NULL;
+        result->rows = 0;
+        result->columns = 0;
+        result->flags = 0;
+    }
 }
 
 void print_matrix(matrix_t A) {
     printf("-----------\n");
     for (int y = 0; y < A.rows; y++) {
         for (int x = 0; x < A.columns; x++) {
-            printf("%15.7lf ", A.matrix[y][x]);
+            printf("%15.7lf ", matrix_is_transposed(&A) ? A.matrix[x][y] : A.matrix[y][x]);
         }
         printf("\n");
     }
@@ -3,15 +3,240 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
 
 #define EPS 0.0000001
+// Точность сравнения матриц float.
+#define EPSF 0.000001
+#define MATRIX_ALIGN 64
+#define MATRIX_BLOCK_HEADER 64
 
+// Уровни SIMD для поэлементных операций.
+#define S21_SIMD_SCALAR 0
+#define S21_SIMD_SSE2   1
+#define S21_SIMD_AVX2   2
+#define S21_SIMD_AVX512 3
+
+// Наибольший размер матриц пакета s21_batch_t и число матриц в его группе.
+#define S21_BATCH_MAX   8
+#define S21_BATCH_LANES 8
+
+// Квадратные матрицы, для которых есть явные формулы s21_matN_*.
+#define FIXED_SIZE(A) ((A)->rows == (A)->columns && (A)->rows >= 2 && (A)->rows <= 4)
+
+// Форматы s21_sparse_t.
+#define S21_CSR 0
+#define S21_CSC 1
+
+// Тип элементов в файле s21_save_matrix.
+#define S21_DTYPE_F64 1
+
+// Форматы текста s21_text_options_t: числа через пробелы/табуляции, запятые или табуляции.
+#define S21_TEXT_SPACE 0
+#define S21_TEXT_CSV   1
+#define S21_TEXT_TSV   2
+
+// Узлы s21_expr_t и их наибольшее число в одном выражении.
+#define S21_EXPR_MATRIX 0
+#define S21_EXPR_SUM    1
+#define S21_EXPR_SUB    2
+#define S21_EXPR_SCALE  3
+#define S21_EXPR_MULT   4
+#define S21_EXPR_NODES  64
+
+// Алгоритмы s21_mult_matrix: обычный блочный или Штрассен-Виноград (быстрее на больших
+// матрицах, погрешность растёт примерно в log2(n / cutoff) раз).
+#define S21_MULT_CLASSIC  0
+#define S21_MULT_STRASSEN 1
+
+// Режимы s21_eq_matrix_tol: |a - b| <= tolerance, |a - b| <= tolerance * max(|a|, |b|) или
+// не больше tolerance представимых чисел между a и b (ULP, не больше S21_EQ_MAX_ULP).
+#define S21_EQ_ABS     0
+#define S21_EQ_REL     1
+#define S21_EQ_ULP     2
+#define S21_EQ_MAX_ULP 4503599627370496.0  // 2^52
+
+// Число дорожек хеша s21_matrix_hash (одна полоса - 64 байта) и операции кэша результатов.
+#define S21_HASH_LANES        8
+#define S21_CACHE_DETERMINANT 0
+#define S21_CACHE_INVERSE     1
+
+// Флаги matrix_t.
+#define S21_TRANSPOSED 1
+#define S21_BORROWED   2
+
+typedef int (*task_fn)(void *arg, int task);
+typedef void (*vec_op_fn)(double *r, const double *a, const double *b, size_t n);
+typedef struct s21_arena s21_arena_t;
+typedef struct s21_pool s21_pool_t;
+
+// При S21_TRANSPOSED элемент (y, x) лежит в matrix[x][y], хранилище - columns x rows.
+// S21_BORROWED: память принадлежит другой матрице, s21_remove_matrix её не освобождает.
 typedef struct matrix_struct {
     double  **matrix;
     int     rows;
     int     columns;
+    int     flags;
 } matrix_t;
 
+// Матрица float: та же раскладка одним блоком, ленивое транспонирование не поддерживается.
+typedef struct matrixf_struct {
+    float   **matrix;
+    int     rows;
+    int     columns;
+    int     flags;
+} matrixf_t;
+
+// LU-разложение PA = LU для многократного решения A * X = B.
+typedef struct s21_lu {
+    matrix_t lu;
+    int     *pivots;
+    int     sign;
+    double  scale;
+} s21_lu_t;
+
+// То же для float (s21_lu_factorf).
+typedef struct s21_luf {
+    matrixf_t lu;
+    int     *pivots;
+    int     sign;
+    float   scale;
+} s21_luf_t;
+
+// Пакет из count матриц rows x columns: структура массивов внутри групп по
+// S21_BATCH_LANES матриц, элемент (y, x) всех матриц группы лежит подряд.
+typedef struct s21_batch {
+    double  *data;
+    int     count;
+    int     rows;
+    int     columns;
+} s21_batch_t;
+
+static inline double *batch_at(const s21_batch_t *batch, int k, int y, int x) {
+    size_t group = (size_t)(k / S21_BATCH_LANES) * batch->rows * batch->columns;
+    return batch->data + (group + (size_t)y * batch->columns + x) * S21_BATCH_LANES + k % S21_BATCH_LANES;
+}
+
+// Разреженная матрица. CSR: строка i - элементы offsets[i]..offsets[i+1]-1, indices - номера
+// столбцов; CSC - то же по столбцам. Индексы внутри строки (столбца) возрастают.
+typedef struct s21_sparse {
+    double  *values;
+    int     *indices;
+    int     *offsets;
+    int     rows;
+    int     columns;
+    int     nnz;
+    int     format;
+} s21_sparse_t;
+
+// Текстовый формат: format - S21_TEXT_*, precision - значащих цифр (0 - кратчайшая точная запись).
+typedef struct s21_text_options {
+    int     format;
+    int     precision;
+} s21_text_options_t;
+
+// Узел отложенного выражения: left и right - номера более ранних узлов, number - множитель
+// S21_EXPR_SCALE, matrix - операнд S21_EXPR_MATRIX (не копируется, должен жить до s21_eval).
+typedef struct s21_expr_node {
+    int     op;
+    int     left;
+    int     right;
+    double  number;
+    matrix_t *matrix;
+} s21_expr_node_t;
+
+// Выражение из узлов без выделения памяти; один узел может быть операндом нескольких.
+typedef struct s21_expr {
+    s21_expr_node_t nodes[S21_EXPR_NODES];
+    int     count;
+} s21_expr_t;
+
+// Представление части матрицы без копирования: элемент (y, x) лежит в
+// base[y' * row_stride + x' * column_stride], где y', x' пропускают skip_row и skip_column.
+typedef struct matrix_view {
+    const double *base;
+    int     rows;
+    int     columns;
+    int     row_stride;
+    int     column_stride;
+    int     skip_row;
+    int     skip_column;
+} matrix_view_t;
+
+// Счётчики кэша результатов; bytes - копии входов и результатов в кэше.
+typedef struct s21_cache_stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t   bytes;
+    size_t   max_bytes;
+    int      entries;
+} s21_cache_stats_t;
+
+// Ключ кэша, вычисленный при поиске и переиспользуемый при записи; valid = 0 - не кэшировать.
+typedef struct cache_key {
+    int      op;
+    int      valid;
+    uint64_t hash;
+} cache_key_t;
+
+static inline double view_at(const matrix_view_t *view, int y, int x) {
+    return view->base[(size_t)(y + (y >= view->skip_row)) * view->row_stride +
+                      (size_t)(x + (x >= view->skip_column)) * view->column_stride];
+}
+
+// Функции, которые считает инструментирование (сборка с -DS21_STATS, make STATS=1).
+#define S21_STATS_FUNCTIONS(X) \
+    X(create_matrix) X(remove_matrix) X(eq_matrix) X(sum_matrix) X(sub_matrix) X(mult_number) \
+    X(mult_matrix) X(transpose) X(calc_complements) X(determinant) X(inverse_matrix) \
+    X(sum_matrix_inplace) X(sub_matrix_inplace) X(mult_number_inplace) X(axpy) X(gemm) \
+    X(transpose_inplace) X(lu_factor) X(lu_solve) X(lu_inverse) X(batch_mult) X(batch_det) \
+    X(batch_inverse) X(sparse_sum) X(sparse_mult_vector) X(sparse_mult_matrix) \
+    X(eval) X(eq_matrix_tol)
+
+#define S21_STATS_ID(name) S21_STAT_##name,
+enum { S21_STATS_FUNCTIONS(S21_STATS_ID) S21_STAT_COUNT };
+
+typedef struct s21_stats_entry {
+    uint64_t calls;
+    uint64_t ns;
+    uint64_t flops;
+} s21_stats_entry_t;
+
+// Байты - блоки матриц и временные буферы; живые матрицы - созданные и ещё не удалённые.
+typedef struct s21_stats {
+    s21_stats_entry_t functions[S21_STAT_COUNT];
+    uint64_t bytes_allocated;
+    uint64_t bytes_freed;
+    int64_t  live_matrices;
+    int64_t  peak_live_matrices;
+    int      enabled;
+} s21_stats_t;
+
+// Матрицы фиксированного размера 2x2, 3x3, 4x4: лежат на стеке, операции не выделяют память.
+#define S21_FIXED_TYPE(N) \
+    typedef struct s21_mat##N { \
+        double m[N][N]; \
+    } s21_mat##N##_t;
+
+S21_FIXED_TYPE(2)
+S21_FIXED_TYPE(3)
+S21_FIXED_TYPE(4)
+
+#define S21_FIXED_SELECT(A, name) \
+    _Generic((A), s21_mat2_t *: s21_mat2_##name, const s21_mat2_t *: s21_mat2_##name, \
+                  s21_mat3_t *: s21_mat3_##name, const s21_mat3_t *: s21_mat3_##name, \
+                  s21_mat4_t *: s21_mat4_##name, const s21_mat4_t *: s21_mat4_##name)
+
+// Выбор функции по типу аргумента: s21_fixed_det(&m3) вызывает s21_mat3_det.
+#define s21_fixed_det(A) S21_FIXED_SELECT(A, det)(A)
+#define s21_fixed_inverse(A, result) S21_FIXED_SELECT(A, inverse)(A, result)
+#define s21_fixed_mult(A, B, result) S21_FIXED_SELECT(A, mult)(A, B, result)
+#define s21_fixed_from(A, result) S21_FIXED_SELECT(result, from)(A, result)
+#define s21_fixed_to(A, result) S21_FIXED_SELECT(A, to)(A, result)
+
 // Основные:
 int   s21_create_matrix(int rows, int columns, matrix_t *result);
 void  s21_remove_matrix(matrix_t *A);
@@ -25,9 +250,216 @@ int   s21_calc_complements(matrix_t *A, matrix_t *result);
 int   s21_determinant(matrix_t *A, double *result);
 int   s21_inverse_matrix(matrix_t *A, matrix_t *result);
 
+// Сравнение с выбранным режимом допуска (S21_EQ_*):
+int   s21_eq_matrix_tol(matrix_t *A, matrix_t *B, int mode, double tolerance);
+
+// Без выделения памяти (результат пишется в уже созданную матрицу):
+int   s21_sum_matrix_inplace(matrix_t *A, matrix_t *B);
+int   s21_sub_matrix_inplace(matrix_t *A, matrix_t *B);
+int   s21_mult_number_inplace(matrix_t *A, double number);
+int   s21_axpy(double alpha, matrix_t *X, matrix_t *Y);
+int   s21_gemm(double alpha, matrix_t *A, matrix_t *B, double beta, matrix_t *C);
+int   s21_transpose_inplace(matrix_t *A);
+
+// LU-разложение:
+int   s21_lu_factor(matrix_t *A, s21_lu_t *lu);
+int   s21_lu_solve(s21_lu_t *lu, matrix_t *B, matrix_t *X);
+int   s21_lu_det(s21_lu_t *lu, double *result);
+int   s21_lu_inverse(s21_lu_t *lu, matrix_t *result);
+int   s21_lu_singular(s21_lu_t *lu);
+void  s21_lu_free(s21_lu_t *lu);
+
+// Пакеты малых матриц (до S21_BATCH_MAX). Как и у matrix_t, при коде 1 или 2 result не выделен
+// и освобождать его не нужно; s21_batch_inverse возвращает 2, если вырождена хоть одна матрица:
+int   s21_batch_create(int count, int rows, int columns, s21_batch_t *batch);
+void  s21_batch_remove(s21_batch_t *batch);
+int   s21_batch_set(s21_batch_t *batch, int index, matrix_t *A);
+int   s21_batch_get(s21_batch_t *batch, int index, matrix_t *result);
+int   s21_batch_mult(s21_batch_t *A, s21_batch_t *B, s21_batch_t *result);
+int   s21_batch_det(s21_batch_t *A, double *result);
+int   s21_batch_inverse(s21_batch_t *A, s21_batch_t *result);
+
+// Разреженные матрицы (format - S21_CSR или S21_CSC):
+int   s21_sparse_create(int rows, int columns, int nnz, int format, s21_sparse_t *result);
+void  s21_sparse_remove(s21_sparse_t *A);
+int   s21_sparse_from_matrix(matrix_t *A, int format, s21_sparse_t *result);
+int   s21_sparse_to_matrix(const s21_sparse_t *A, matrix_t *result);
+int   s21_sparse_convert(const s21_sparse_t *A, int format, s21_sparse_t *result);
+int   s21_sparse_transpose(const s21_sparse_t *A, s21_sparse_t *result);
+int   s21_sparse_sum(const s21_sparse_t *A, const s21_sparse_t *B, s21_sparse_t *result);
+int   s21_sparse_mult_vector(const s21_sparse_t *A, const double *x, double *y);
+int   s21_sparse_mult_matrix(const s21_sparse_t *A, matrix_t *B, matrix_t *result);
+
+// Файлы (двоичный формат: заголовок 64 байта, затем элементы по строкам):
+int   s21_save_matrix(matrix_t *A, const char *path);
+int   s21_load_matrix(const char *path, matrix_t *result);
+int   s21_mmap_matrix(const char *path, matrix_t *result);
+
+// Текст (opt == NULL - числа через пробелы, кратчайшая точная запись):
+int   s21_write_matrix_text(FILE *f, matrix_t *A, const s21_text_options_t *opt);
+int   s21_read_matrix_text(FILE *f, const s21_text_options_t *opt, int max_rows, matrix_t *result);
+
+// Отложенные выражения (конструкторы возвращают номер узла или -1, -1 в операнде даёт -1):
+void  s21_expr_init(s21_expr_t *expr);
+int   s21_expr_matrix(s21_expr_t *expr, matrix_t *A);
+int   s21_expr_sum(s21_expr_t *expr, int a, int b);
+int   s21_expr_sub(s21_expr_t *expr, int a, int b);
+int   s21_expr_scale(s21_expr_t *expr, int a, double number);
+int   s21_expr_mult(s21_expr_t *expr, int a, int b);
+int   s21_eval(s21_expr_t *expr, int root, matrix_t *result);
+
+// Представления:
+int   s21_transpose_lazy(matrix_t *A, matrix_t *result);
+int   s21_matrix_view(matrix_t *A, matrix_view_t *view);
+int   s21_submatrix_view(matrix_t *A, int row, int column, int rows, int columns, matrix_view_t *view);
+int   s21_minor_view(matrix_t *A, int oy, int ox, matrix_view_t *view);
+int   s21_view_to_matrix(const matrix_view_t *view, matrix_t *result);
+int   s21_view_determinant(const matrix_view_t *view, double *result);
+
+// Арены и пулы (матрицы из них удаляются обычным s21_remove_matrix):
+s21_arena_t *s21_arena_create(size_t capacity);
+void  s21_arena_reset(s21_arena_t *arena);
+void  s21_arena_destroy(s21_arena_t *arena);
+int   s21_create_matrix_in(s21_arena_t *arena, int rows, int columns, matrix_t *result);
+s21_pool_t *s21_pool_create(void);
+void  s21_pool_destroy(s21_pool_t *pool);
+int   s21_create_matrix_pooled(s21_pool_t *pool, int rows, int columns, matrix_t *result);
+
+// Потоки:
+int   s21_set_num_threads(int count);
+int   s21_get_num_threads(void);
+
+// Фиксированный размер (N = 2, 3, 4):
+#define S21_FIXED_API(N) \
+    double  s21_mat##N##_det(const s21_mat##N##_t *A); \
+    int     s21_mat##N##_inverse(const s21_mat##N##_t *A, s21_mat##N##_t *result); \
+    void    s21_mat##N##_mult(const s21_mat##N##_t *A, const s21_mat##N##_t *B, s21_mat##N##_t *result); \
+    int     s21_mat##N##_from(matrix_t *A, s21_mat##N##_t *result); \
+    int     s21_mat##N##_to(const s21_mat##N##_t *A, matrix_t *result);
+
+S21_FIXED_API(2)
+S21_FIXED_API(3)
+S21_FIXED_API(4)
+
+// float: основные, операции на месте и LU (раскладка блока и LU общие с double, s21_real_kernels.h):
+int   s21_create_matrixf(int rows, int columns, matrixf_t *result);
+void  s21_remove_matrixf(matrixf_t *A);
+int   s21_eq_matrixf(matrixf_t *A, matrixf_t *B);
+int   s21_sum_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result);
+int   s21_sub_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result);
+int   s21_mult_numberf(matrixf_t *A, float number, matrixf_t *result);
+int   s21_mult_matrixf(matrixf_t *A, matrixf_t *B, matrixf_t *result);
+int   s21_transposef(matrixf_t *A, matrixf_t *result);
+int   s21_calc_complementsf(matrixf_t *A, matrixf_t *result);
+int   s21_determinantf(matrixf_t *A, float *result);
+int   s21_inverse_matrixf(matrixf_t *A, matrixf_t *result);
+int   s21_sum_matrix_inplacef(matrixf_t *A, matrixf_t *B);
+int   s21_sub_matrix_inplacef(matrixf_t *A, matrixf_t *B);
+int   s21_mult_number_inplacef(matrixf_t *A, float number);
+int   s21_axpyf(float alpha, matrixf_t *X, matrixf_t *Y);
+int   s21_lu_factorf(matrixf_t *A, s21_luf_t *lu);
+int   s21_lu_solvef(s21_luf_t *lu, matrixf_t *B, matrixf_t *X);
+int   s21_lu_detf(s21_luf_t *lu, float *result);
+int   s21_lu_inversef(s21_luf_t *lu, matrixf_t *result);
+int   s21_lu_singularf(s21_luf_t *lu);
+void  s21_lu_freef(s21_luf_t *lu);
+
+// float и смешанная точность (разложение во float, уточнение до точности double):
+int   s21_matrix_to_float(matrix_t *A, matrixf_t *result);
+int   s21_matrix_from_float(matrixf_t *A, matrix_t *result);
+int   s21_solve_mixed(matrix_t *A, matrix_t *B, matrix_t *X, int *iterations);
+
+// Хеш содержимого и кэш s21_determinant/s21_inverse_matrix (по умолчанию выключен, лимит 0):
+uint64_t s21_matrix_hash(matrix_t *A);
+void  s21_set_cache_limit(size_t max_bytes);
+void  s21_cache_clear(void);
+void  s21_cache_snapshot(s21_cache_stats_t *result);
+
+// Статистика вызовов (без S21_STATS snapshot возвращает 1 и нули):
+int   s21_stats_snapshot(s21_stats_t *result);
+void  s21_stats_reset(void);
+int   s21_stats_dump_json(FILE *out);
+const char *s21_stats_name(int id);
+
+// Алгоритм умножения (cutoff - сторона, ниже которой Штрассен не делит; 0 - по умолчанию):
+int   s21_set_mult_policy(int policy, int cutoff);
+int   s21_get_mult_policy(void);
+
+// SIMD:
+int   s21_simd_supported(void);
+int   s21_set_simd_level(int level);
+int   s21_get_simd_level(void);
+
+// Инструментирование: STATS_BEGIN() в начале функции, STATS_END(имя, flops) перед return.
+// Без S21_STATS макросы пустые и аргументы не вычисляются.
+#ifdef S21_STATS
+#define STATS_BEGIN() uint64_t stats_start = stats_clock()
+#define STATS_END(name, flops) stats_record(S21_STAT_##name, stats_start, (flops))
+#define STATS_ALLOC(bytes) stats_alloc(bytes)
+#define STATS_FREE(bytes) stats_free(bytes)
+#define STATS_LIVE(delta) stats_live(delta)
+#else
+#define STATS_BEGIN() ((void)0)
+#define STATS_END(name, flops) ((void)0)
+#define STATS_ALLOC(bytes) ((void)0)
+#define STATS_FREE(bytes) ((void)0)
+#define STATS_LIVE(delta) ((void)0)
+#endif
+
 // Вспомогательные:
+uint64_t stats_clock(void);
+void    stats_record(int id, uint64_t start, double flops);
+void    stats_alloc(size_t bytes);
+void    stats_free(size_t bytes);
+void    stats_live(int delta);
 void    get_minor(matrix_t *A, matrix_t *result, int oy, int ox);
 void    print_matrix(matrix_t A);
 int     matrix_is_empty(matrix_t *A);
+int     check_same_size(matrix_t *A, matrix_t *B);
+int     matrix_is_transposed(matrix_t *A);
+void    matrix_strides(matrix_t *A, int *row_stride, int *column_stride);
+void    matrix_to_buffer(matrix_t *A, double *buf);
+const double *oriented_data(matrix_t *A, int transposed, double **tmp);
+size_t  matrix_bytes(int rows, int columns);
+size_t  matrix_bytesf(int rows, int columns);
+void    matrix_layout(void *mem, int rows, int columns, matrix_t *result);
+void    matrix_layoutf(void *mem, int rows, int columns, matrixf_t *result);
+int     lu_substitute(s21_lu_t *lu, double *x, int m);
+int     lu_substitutef(s21_luf_t *lu, float *x, int m);
+void    *matrix_block_alloc(size_t bytes);
+void    matrix_block_release(void *mem);
+int     matrix_reshape(matrix_t *A, int rows, int columns);
+int     matrix_map(void *map, size_t map_size, size_t offset, int rows, int columns, matrix_t *result);
+double  *scratch_alloc(size_t count);
+void    scratch_free(double *buf);
+void    view_to_buffer(const matrix_view_t *view, double *buf);
+double  *copy_to_buffer(matrix_t *A);
+void    swap_rows(double *buf, int columns, int y1, int y2);
+double  lu_determinant(double *buf, int n);
+int     gauss_jordan_inverse(double *buf, int n, matrix_t *result);
+int     lu_complements(double *a, int n, matrix_t *result);
+double  lu_complete_pivot(double *a, int n, int *pr, int *qc, double *d);
+int     strassen_applies(int m, int n, int k);
+int     strassen_mult(matrix_t *A, matrix_t *B, matrix_t *result);
+int     gemm_blocked(int m, int n, int k, double alpha, const double *A, int rsa, int csa,
+                     const double *B, int rsb, int csb, double *C, int ldc);
+int     cache_lookup(int op, matrix_t *A, cache_key_t *key, double *number, matrix_t *result);
+void    cache_store(const cache_key_t *key, matrix_t *A, double number, matrix_t *result);
+double  fixed_determinant(matrix_t *A);
+int     fixed_inverse(matrix_t *A, matrix_t *result);
+void    fixed_mult(matrix_t *A, matrix_t *B, matrix_t *result);
+void    transpose_blocked(const double *src, int rows, int columns, double *dst);
+int     parallel_for(int tasks, task_fn fn, void *arg);
+void    vec_add(double *r, const double *a, const double *b, size_t n);
+void    vec_sub(double *r, const double *a, const double *b, size_t n);
+void    vec_scale(double *r, const double *a, double s, size_t n);
+void    vec_axpy(double *y, const double *x, double alpha, size_t n);
+void    vec_axpyf(float *y, const float *x, float alpha, size_t n);
+int     vec_eq(const double *a, const double *b, size_t n, double eps);
+int     vec_eq_abs(const double *a, const double *b, size_t n, double tolerance);
+int     vec_eq_rel(const double *a, const double *b, size_t n, double tolerance);
+int     vec_eq_ulp(const double *a, const double *b, size_t n, int64_t ulps);
+void    vec_transpose(double *dst, size_t ldd, const double *src, size_t lds, int rows, int cols);
+void    vec_hash(uint64_t *acc, const double *a, size_t stripes, size_t first);
 
 #endif  //  SRC_S21_MATRIX_H_
@@ -0,0 +1,204 @@
+// NOLINT(build/header_guard)
+// Шаблон s21_lu.c, общий для double и float: раскладка блока матрицы и LU-разложение.
+// Подключается один раз на тип элемента с заданными REAL (тип элемента), MATRIX (тип матрицы),
+// REAL_LU (тип разложения), NAME(name) (открытое имя), REAL_FN(name) (внутреннее имя),
+// REAL_EPS (порог вырожденности), REAL_EMPTY(A), REAL_LOAD(A, buf) (копия A по строкам),
+// REAL_AXPY, REAL_SCALE (как vec_axpy, vec_scale), REAL_GEMM_SUB(m, n, k, A, lda, B, ldb, C, ldc)
+// (C -= A * B, 2 - нет памяти) и REAL_STATS_BEGIN(), REAL_STATS_END(name, flops).
+
+static void REAL_FN(lu_swap)(REAL *buf, size_t columns, size_t y1, size_t y2);
+
+size_t REAL_FN(matrix_bytes)(int rows, int columns) {
+    size_t bytes = 0;
+
+    if (rows > 0 && columns > 0) {
+        size_t head = MATRIX_BLOCK_HEADER + (size_t)rows * sizeof(REAL *) + MATRIX_ALIGN;
+        size_t size = (size_t)rows * (size_t)columns;
+        if (size / (size_t)rows == (size_t)columns && size <= (SIZE_MAX - head) / sizeof(REAL))
+            bytes = head + size * sizeof(REAL);
+    }
+
+    return bytes;
+}
+
+// Массив указателей на строки сразу за заголовком, данные выровнены на MATRIX_ALIGN.
+void REAL_FN(matrix_layout)(void *mem, int rows, int columns, MATRIX *result) {
+    result->rows = rows;
+    result->columns = columns;
+    result->flags = 0;
+    result->matrix = (REAL **)((char *)mem + MATRIX_BLOCK_HEADER);
+
+    uintptr_t data = (uintptr_t)(result->matrix + rows);
+    data = (data + MATRIX_ALIGN - 1) & ~(uintptr_t)(MATRIX_ALIGN - 1);
+    for (int y = 0; y < rows; y++)
+        result->matrix[y] = (REAL *)data + (size_t)y * columns;
+}
+
+int NAME(lu_factor)(MATRIX *A, REAL_LU *lu) {
+    REAL_STATS_BEGIN();
+    int ret = 0;
+    lu->lu.matrix = NULL;
+    lu->pivots = NULL;
+
+    if (REAL_EMPTY(A)) {
+        ret = 1;
+    } else if (A->rows != A->columns) {
+        ret = 2;
+    } else if (NAME(create_matrix)(A->rows, A->columns, &lu->lu) != 0 ||
+               (lu->pivots = (int *)malloc(sizeof(int) * A->rows)) == NULL) {
+        ret = 2;
+        NAME(lu_free)(lu);
+    } else {
+        size_t n = (size_t)A->rows;
+        REAL *a = lu->lu.matrix[0];
+        REAL_LOAD(A, a);
+
+        lu->sign = 1;
+        lu->scale = 0;
+        for (size_t i = 0; i < n * n; i++)
+            if (fabs(a[i]) > lu->scale)
+                lu->scale = fabs(a[i]);
+
+        // Частичный выбор ведущего элемента, L хранится под диагональю без единиц.
+        for (size_t k = 0; k < n; k++) {
+            size_t p = k;
+            for (size_t y = k + 1; y < n; y++)
+                if (fabs(a[y * n + k]) > fabs(a[p * n + k]))
+                    p = y;
+            lu->pivots[k] = (int)p;
+            if (p != k) {
+                REAL_FN(lu_swap)(a, n, p, k);
+                lu->sign = -lu->sign;
+            }
+            for (size_t y = k + 1; y < n && a[k * n + k] != 0; y++) {
+                REAL l = a[y * n + k] /= a[k * n + k];
+                if (l != 0)
+                    REAL_AXPY(a + y * n + k + 1, a + k * n + k + 1, -l, n - k - 1);
+            }
+        }
+    }
+
+    REAL_STATS_END(lu_factor, ret ? 0 : 2.0 / 3 * A->rows * A->rows * A->rows);
+    return ret;
+}
+
+void NAME(lu_free)(REAL_LU *lu) {
+    NAME(remove_matrix)(&lu->lu);
+    free(lu->pivots);
+    lu->pivots = NULL;
+}
+
+int NAME(lu_det)(REAL_LU *lu, REAL *result) {
+    int ret = 0;
+
+    if (lu == NULL || REAL_EMPTY(&lu->lu)) {
+        ret = 1;
+    } else {
+        *result = lu->sign;
+        for (int k = 0; k < lu->lu.rows; k++)
+            *result *= lu->lu.matrix[k][k];
+    }
+
+    return ret;
+}
+
+int NAME(lu_singular)(REAL_LU *lu) {
+    int ret = 0;
+
+    for (int k = 0; k < lu->lu.rows && !ret; k++)
+        if (lu->scale == 0 || fabs(lu->lu.matrix[k][k]) <= REAL_EPS * lu->scale)
+            ret = 1;
+
+    return ret;
+}
+
+int NAME(lu_solve)(REAL_LU *lu, MATRIX *B, MATRIX *X) {
+    REAL_STATS_BEGIN();
+    int ret = 0;
+
+    if (lu == NULL || REAL_EMPTY(&lu->lu) || REAL_EMPTY(B)) {
+        ret = 1;
+    } else if (B->rows != lu->lu.rows || NAME(lu_singular)(lu)) {
+        ret = 2;
+    } else if (NAME(create_matrix)(B->rows, B->columns, X) != 0) {
+        ret = 2;
+    } else {
+        REAL_LOAD(B, X->matrix[0]);
+        // Без памяти под упаковку блоков умножения решение неполное: X не возвращается.
+        if (REAL_FN(lu_substitute)(lu, X->matrix[0], X->columns) != 0) {
+            ret = 2;
+            NAME(remove_matrix)(X);
+        }
+    }
+
+    REAL_STATS_END(lu_solve, ret ? 0 : 2.0 * B->rows * B->rows * B->columns);
+    return ret;
+}
+
+int NAME(lu_inverse)(REAL_LU *lu, MATRIX *result) {
+    REAL_STATS_BEGIN();
+    int ret = 0;
+    MATRIX I;
+
+    if (lu == NULL || REAL_EMPTY(&lu->lu)) {
+        ret = 1;
+    } else if (NAME(create_matrix)(lu->lu.rows, lu->lu.rows, &I) != 0) {
+        ret = 2;
+    } else {
+        for (int k = 0; k < I.rows; k++)
+            I.matrix[k][k] = 1;
+        ret = NAME(lu_solve)(lu, &I, result);
+        NAME(remove_matrix)(&I);
+    }
+
+    REAL_STATS_END(lu_inverse, ret ? 0 : 2.0 * lu->lu.rows * lu->lu.rows * lu->lu.rows);
+    return ret;
+}
+
+/*
+ * X (n x m по строкам) заменяется решением A X = X: перестановки, затем L Y = X и U Z = Y.
+ * Блок строк сначала обновляется одним умножением по уже решённым строкам, внутри блока -
+ * построчно. 2 - умножению не хватило памяти.
+ */
+int REAL_FN(lu_substitute)(REAL_LU *lu, REAL *x, int m) {
+    int ret = 0, n = lu->lu.rows;
+    const REAL *a = lu->lu.matrix[0];
+
+    for (int k = 0; k < n; k++)
+        if (lu->pivots[k] != k)
+            REAL_FN(lu_swap)(x, (size_t)m, (size_t)k, (size_t)lu->pivots[k]);
+    for (int ib = 0; ib < n && ret == 0; ib += LU_SOLVE_NB) {
+        int ie = ib + LU_SOLVE_NB < n ? ib + LU_SOLVE_NB : n;
+        if (ib > 0)
+            ret = REAL_GEMM_SUB(ie - ib, m, ib, a + (size_t)ib * n, n, x, m, x + (size_t)ib * m, m);
+        for (int i = ib; i < ie; i++)
+            for (int j = ib; j < i; j++)
+                if (a[(size_t)i * n + j] != 0)
+                    REAL_AXPY(x + (size_t)i * m, x + (size_t)j * m, -a[(size_t)i * n + j], m);
+    }
+    for (int ie = n; ie > 0 && ret == 0; ie -= LU_SOLVE_NB) {
+        int ib = ie - LU_SOLVE_NB > 0 ? ie - LU_SOLVE_NB : 0;
+        if (ie < n)
+            ret = REAL_GEMM_SUB(ie - ib, m, n - ie, a + (size_t)ib * n + ie, n, x + (size_t)ie * m, m,
+                                x + (size_t)ib * m, m);
+        for (int i = ie - 1; i >= ib; i--) {
+            REAL *r = x + (size_t)i * m;
+            for (int j = i + 1; j < ie; j++)
+                if (a[(size_t)i * n + j] != 0)
+                    REAL_AXPY(r, x + (size_t)j * m, -a[(size_t)i * n + j], m);
+            REAL_SCALE(r, r, 1 / a[(size_t)i * n + i], m);
+        }
+    }
+
+    return ret;
+}
+
+static void REAL_FN(lu_swap)(REAL *buf, size_t columns, size_t y1, size_t y2) {
+    REAL *a = buf + y1 * columns, *b = buf + y2 * columns;
+
+    for (size_t x = 0; x < columns; x++) {
+        REAL t = a[x];
+        a[x] = b[x];
+        b[x] = t;
+    }
+}
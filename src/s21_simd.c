@@ -0,0 +1,533 @@
+#include "s21_matrix.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+// Таблица поэлементных ядер одного уровня SIMD.
+typedef struct simd_kernels {
+    void (*add)(double *r, const double *a, const double *b, size_t n);
+    void (*sub)(double *r, const double *a, const double *b, size_t n);
+    void (*scale)(double *r, const double *a, double s, size_t n);
+    void (*axpy)(double *y, const double *x, double alpha, size_t n);
+    void (*axpyf)(float *y, const float *x, float alpha, size_t n);
+    int  (*eq)(const double *a, const double *b, size_t n, double eps);
+    int  (*eq_abs)(const double *a, const double *b, size_t n, double tolerance);
+    int  (*eq_rel)(const double *a, const double *b, size_t n, double tolerance);
+    int  (*eq_ulp)(const double *a, const double *b, size_t n, int64_t ulps);
+    void (*transpose)(double *dst, size_t ldd, const double *src, size_t lds, int rows, int cols);
+    void (*hash)(uint64_t *acc, const double *a, size_t stripes, size_t first);
+} simd_kernels_t;
+
+// Ключи дорожек хеша; у каждой следующей полосы ключ больше на HASH_STEP, поэтому
+// перестановка строк или столбцов меняет хеш.
+#define HASH_STEP 0x9E3779B97F4A7C15ull
+static const uint64_t hash_secret[S21_HASH_LANES] = {
+    0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+    0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull};
+
+static void add_scalar(double *r, const double *a, const double *b, size_t n);
+static void sub_scalar(double *r, const double *a, const double *b, size_t n);
+static void scale_scalar(double *r, const double *a, double s, size_t n);
+static void axpy_scalar(double *y, const double *x, double alpha, size_t n);
+static void axpyf_scalar(float *y, const float *x, float alpha, size_t n);
+static int eq_scalar(const double *a, const double *b, size_t n, double eps);
+static int eq_abs_scalar(const double *a, const double *b, size_t n, double tolerance);
+static int eq_rel_scalar(const double *a, const double *b, size_t n, double tolerance);
+static int eq_ulp_scalar(const double *a, const double *b, size_t n, int64_t ulps);
+static void transpose_scalar(double *dst, size_t ldd, const double *src, size_t lds, int rows, int cols);
+static void hash_scalar(uint64_t *acc, const double *a, size_t stripes, size_t first);
+static const simd_kernels_t *kernels_for(int level);
+
+static const simd_kernels_t scalar_kernels = {add_scalar, sub_scalar, scale_scalar, axpy_scalar,
+                                                 axpyf_scalar, eq_scalar, eq_abs_scalar, eq_rel_scalar,
+                                                 eq_ulp_scalar, transpose_scalar, hash_scalar};
+// s21_set_simd_level может вызываться параллельно с операциями: доступ только атомарный.
+// Таблицы ядер - статические константы, поэтому достаточно RELAXED.
+static const simd_kernels_t *active = &scalar_kernels;
+static int active_level = S21_SIMD_SCALAR;
+
+#define ACTIVE __atomic_load_n(&active, __ATOMIC_RELAXED)
+
+int s21_simd_supported(void) {
+    int level = S21_SIMD_SCALAR;
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+        level = S21_SIMD_SSE2;
+    if (level == S21_SIMD_SSE2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        level = S21_SIMD_AVX2;
+    if (level == S21_SIMD_AVX2 && __builtin_cpu_supports("avx512f"))
+        level = S21_SIMD_AVX512;
+#endif
+    return level;
+}
+
+int s21_set_simd_level(int level) {
+    int ret = 0;
+
+    if (level < 0) {
+        level = s21_simd_supported();
+    }
+    if (level > s21_simd_supported()) {
+        ret = 1;
+    } else {
+        __atomic_store_n(&active, kernels_for(level), __ATOMIC_RELAXED);
+        __atomic_store_n(&active_level, level, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+int s21_get_simd_level(void) {
+    return __atomic_load_n(&active_level, __ATOMIC_RELAXED);
+}
+
+// Выбор лучшего уровня при загрузке библиотеки по CPUID.
+__attribute__((constructor)) static void simd_init(void) {
+    s21_set_simd_level(-1);
+}
+
+void vec_add(double *r, const double *a, const double *b, size_t n) {
+    ACTIVE->add(r, a, b, n);
+}
+
+void vec_sub(double *r, const double *a, const double *b, size_t n) {
+    ACTIVE->sub(r, a, b, n);
+}
+
+void vec_scale(double *r, const double *a, double s, size_t n) {
+    ACTIVE->scale(r, a, s, n);
+}
+
+void vec_axpy(double *y, const double *x, double alpha, size_t n) {
+    ACTIVE->axpy(y, x, alpha, n);
+}
+
+void vec_axpyf(float *y, const float *x, float alpha, size_t n) {
+    ACTIVE->axpyf(y, x, alpha, n);
+}
+
+int vec_eq(const double *a, const double *b, size_t n, double eps) {
+    return ACTIVE->eq(a, b, n, eps);
+}
+
+int vec_eq_abs(const double *a, const double *b, size_t n, double tolerance) {
+    return ACTIVE->eq_abs(a, b, n, tolerance);
+}
+
+int vec_eq_rel(const double *a, const double *b, size_t n, double tolerance) {
+    return ACTIVE->eq_rel(a, b, n, tolerance);
+}
+
+int vec_eq_ulp(const double *a, const double *b, size_t n, int64_t ulps) {
+    return ACTIVE->eq_ulp(a, b, n, ulps);
+}
+
+void vec_transpose(double *dst, size_t ldd, const double *src, size_t lds, int rows, int cols) {
+    ACTIVE->transpose(dst, ldd, src, lds, rows, cols);
+}
+
+void vec_hash(uint64_t *acc, const double *a, size_t stripes, size_t first) {
+    ACTIVE->hash(acc, a, stripes, first);
+}
+
+static void add_scalar(double *r, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        r[i] = a[i] + b[i];
+}
+
+static void sub_scalar(double *r, const double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        r[i] = a[i] - b[i];
+}
+
+static void scale_scalar(double *r, const double *a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        r[i] = a[i] * s;
+}
+
+static void axpy_scalar(double *y, const double *x, double alpha, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+static void axpyf_scalar(float *y, const float *x, float alpha, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+static int eq_scalar(const double *a, const double *b, size_t n, double eps) {
+    int ret = 1;
+
+    for (size_t i = 0; i < n && ret; i++)
+        if (fabs(a[i] - b[i]) > eps)
+            ret = 0;
+
+    return ret;
+}
+
+// Равные a и b (в том числе бесконечности) равны. В режимах с допуском NaN равен только NaN:
+// в отличие от eq_scalar, неравенство здесь - !(|a - b| <= tolerance).
+static int eq_abs_scalar(const double *a, const double *b, size_t n, double tolerance) {
+    int ret = 1;
+
+    for (size_t i = 0; i < n && ret; i++) {
+        int nan = (a[i] != a[i]) + (b[i] != b[i]);
+        ret = a[i] == b[i] || fabs(a[i] - b[i]) <= tolerance || nan == 2;
+    }
+
+    return ret;
+}
+
+// Как eq_abs_scalar, кроме того, разность должна быть конечной.
+static int eq_rel_scalar(const double *a, const double *b, size_t n, double tolerance) {
+    int ret = 1;
+
+    for (size_t i = 0; i < n && ret; i++) {
+        double d = fabs(a[i] - b[i]);
+        int nan = (a[i] != a[i]) + (b[i] != b[i]);
+        ret = a[i] == b[i] || (d <= tolerance * fmax(fabs(a[i]), fabs(b[i])) && d < INFINITY) || nan == 2;
+    }
+
+    return ret;
+}
+
+/*
+ * Биты double с отрицательным знаком переворачиваются, и числа становятся упорядоченными
+ * целыми: соседние double отличаются на 1. Расстояние считается без знака, поэтому
+ * переполнение разности не выдаёт далёкие числа за близкие.
+ */
+static int eq_ulp_scalar(const double *a, const double *b, size_t n, int64_t ulps) {
+    int ret = 1;
+
+    for (size_t i = 0; i < n && ret; i++) {
+        int64_t x, y;
+        memcpy(&x, a + i, sizeof(x));
+        memcpy(&y, b + i, sizeof(y));
+        uint64_t d = (uint64_t)(x < 0 ? x ^ INT64_MAX : x) - (uint64_t)(y < 0 ? y ^ INT64_MAX : y);
+        d = d > (uint64_t)INT64_MAX ? -d : d;
+        int nan = (a[i] != a[i]) + (b[i] != b[i]);
+        ret = a[i] == b[i] || (nan == 0 ? d <= (uint64_t)ulps : nan == 2);
+    }
+
+    return ret;
+}
+
+static void transpose_scalar(double *dst, size_t ldd, const double *src, size_t lds, int rows, int cols) {
+    for (int y = 0; y < rows; y++)
+        for (int x = 0; x < cols; x++)
+            dst[x * ldd + y] = src[y * lds + x];
+}
+
+/*
+ * Полоса - S21_HASH_LANES подряд идущих чисел, по числу на дорожку. Как в XXH3, дорожка
+ * прибавляет само число и произведение половин (число ^ ключ): умножение 32 x 32 -> 64 есть
+ * на всех уровнях SIMD, поэтому результат от уровня не зависит. first - номер первой полосы.
+ */
+static void hash_scalar(uint64_t *acc, const double *a, size_t stripes, size_t first) {
+    for (size_t s = 0; s < stripes; s++) {
+        for (int l = 0; l < S21_HASH_LANES; l++) {
+            uint64_t x, k;
+            memcpy(&x, a + s * S21_HASH_LANES + l, sizeof(x));
+            k = x ^ (hash_secret[l] + (first + s) * HASH_STEP);
+            acc[l] += x + (k & 0xFFFFFFFFu) * (k >> 32);
+        }
+    }
+}
+
+#if SIMD_X86
+// Блок W x W транспонируется в регистрах, края тайла - скалярно.
+#define TRANSPOSE_TILE(SUFFIX, TARGET, W, MICRO) \
+    __attribute__((target(TARGET))) static void transpose_##SUFFIX(double *dst, size_t ldd, \
+                                                                   const double *src, size_t lds, \
+                                                                   int rows, int cols) { \
+        int ye = rows - rows % W, xe = cols - cols % W; \
+        for (int y = 0; y < ye; y += W) \
+            for (int x = 0; x < xe; x += W) \
+                MICRO(dst + x * ldd + y, ldd, src + y * lds + x, lds); \
+        transpose_scalar(dst + xe * ldd, ldd, src + xe, lds, ye, cols - xe); \
+        transpose_scalar(dst + ye, ldd, src + ye * lds, lds, rows - ye, cols); \
+    }
+
+__attribute__((target("sse2"))) static inline void micro_sse2(double *d, size_t ldd, const double *s,
+                                                              size_t lds) {
+    __m128d r0 = _mm_loadu_pd(s), r1 = _mm_loadu_pd(s + lds);
+    _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd(d + ldd, _mm_unpackhi_pd(r0, r1));
+}
+
+__attribute__((target("avx2"))) static inline void micro_avx2(double *d, size_t ldd, const double *s,
+                                                              size_t lds) {
+    __m256d r0 = _mm256_loadu_pd(s), r1 = _mm256_loadu_pd(s + lds);
+    __m256d r2 = _mm256_loadu_pd(s + 2 * lds), r3 = _mm256_loadu_pd(s + 3 * lds);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(d + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(d + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(d + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+// 8x8: чередование пар строк, затем четвёрок, затем половины склеиваются при записи.
+__attribute__((target("avx512f"))) static inline void micro_avx512(double *d, size_t ldd,
+                                                                   const double *s, size_t lds) {
+    __m512i lo = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+    __m512i hi = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+    __m512d r[8], t[8];
+    for (int i = 0; i < 8; i++)
+        r[i] = _mm512_loadu_pd(s + i * lds);
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm512_unpacklo_pd(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_pd(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        r[i] = _mm512_permutex2var_pd(t[i], lo, t[i + 2]);
+        r[i + 1] = _mm512_permutex2var_pd(t[i + 1], lo, t[i + 3]);
+        r[i + 2] = _mm512_permutex2var_pd(t[i], hi, t[i + 2]);
+        r[i + 3] = _mm512_permutex2var_pd(t[i + 1], hi, t[i + 3]);
+    }
+    for (int i = 0; i < 4; i++) {
+        _mm512_storeu_pd(d + i * ldd, _mm512_shuffle_f64x2(r[i], r[i + 4], 0x44));
+        _mm512_storeu_pd(d + (i + 4) * ldd, _mm512_shuffle_f64x2(r[i], r[i + 4], 0xEE));
+    }
+}
+
+TRANSPOSE_TILE(sse2, "sse2", 2, micro_sse2)
+TRANSPOSE_TILE(avx2, "avx2", 4, micro_avx2)
+TRANSPOSE_TILE(avx512, "avx512f", 8, micro_avx512)
+
+// y += alpha * x для float: в регистре вдвое больше элементов, чем у double.
+#define AXPYF_KERNEL(SUFFIX, TARGET, VEC, W, LOAD, STORE, SET1, MADD) \
+    __attribute__((target(TARGET))) static void axpyf_##SUFFIX(float *y, const float *x, \
+                                                               float alpha, size_t n) { \
+        VEC va = SET1(alpha); \
+        size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            STORE(y + i, MADD(va, LOAD(x + i), LOAD(y + i))); \
+        axpyf_scalar(y + i, x + i, alpha, n - i); \
+    }
+
+#define SSE2_MADDF(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+
+AXPYF_KERNEL(sse2, "sse2", __m128, 4, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, SSE2_MADDF)
+AXPYF_KERNEL(avx2, "avx2,fma", __m256, 8, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_fmadd_ps)
+AXPYF_KERNEL(avx512, "avx512f", __m512, 16, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+             _mm512_fmadd_ps)
+
+// Сравнение с допуском: BAD(a, b, t) не ноль, если в векторе есть неравная пара.
+#define EQ_MODE_KERNEL(NAME, SUFFIX, TARGET, VEC, TOL, W, LOAD, SET1, BAD) \
+    __attribute__((target(TARGET))) static int NAME##_##SUFFIX(const double *a, const double *b, \
+                                                               size_t n, TOL tolerance) { \
+        VEC vt = SET1(tolerance); \
+        int ret = 1; \
+        size_t i = 0; \
+        for (; i + W <= n && ret; i += W) \
+            if (BAD(LOAD(a + i), LOAD(b + i), vt)) \
+                ret = 0; \
+        return ret && NAME##_scalar(a + i, b + i, n - i, tolerance); \
+    }
+
+__attribute__((target("sse2"))) static inline int rel_bad_sse2(__m128d a, __m128d b, __m128d t) {
+    __m128d sign = _mm_set1_pd(-0.0), d = _mm_andnot_pd(sign, _mm_sub_pd(a, b));
+    __m128d m = _mm_mul_pd(t, _mm_max_pd(_mm_andnot_pd(sign, a), _mm_andnot_pd(sign, b)));
+    __m128d ok = _mm_and_pd(_mm_cmple_pd(d, m), _mm_cmplt_pd(d, _mm_set1_pd(INFINITY)));
+    __m128d nan = _mm_and_pd(_mm_cmpunord_pd(a, a), _mm_cmpunord_pd(b, b));
+    return _mm_movemask_pd(_mm_or_pd(_mm_or_pd(ok, nan), _mm_cmpeq_pd(a, b))) != 0x3;
+}
+
+__attribute__((target("sse2"))) static inline int abs_bad_sse2(__m128d a, __m128d b, __m128d t) {
+    __m128d ok = _mm_cmple_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), _mm_sub_pd(a, b)), t);
+    __m128d nan = _mm_and_pd(_mm_cmpunord_pd(a, a), _mm_cmpunord_pd(b, b));
+    return _mm_movemask_pd(_mm_or_pd(_mm_or_pd(ok, nan), _mm_cmpeq_pd(a, b))) != 0x3;
+}
+
+// Обе стороны NaN.
+__attribute__((target("avx2"))) static inline __m256d nan_pair_avx2(__m256d a, __m256d b) {
+    return _mm256_and_pd(_mm256_cmp_pd(a, a, _CMP_UNORD_Q), _mm256_cmp_pd(b, b, _CMP_UNORD_Q));
+}
+
+__attribute__((target("avx512f"))) static inline __mmask8 nan_pair_avx512(__m512d a, __m512d b) {
+    return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q) & _mm512_cmp_pd_mask(b, b, _CMP_UNORD_Q);
+}
+
+__attribute__((target("avx2"))) static inline int abs_bad_avx2(__m256d a, __m256d b, __m256d t) {
+    __m256d d = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(a, b));
+    __m256d ok = _mm256_cmp_pd(d, t, _CMP_LE_OQ);
+    return _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(ok, nan_pair_avx2(a, b)),
+                                           _mm256_cmp_pd(a, b, _CMP_EQ_OQ))) != 0xF;
+}
+
+__attribute__((target("avx512f"))) static inline int abs_bad_avx512(__m512d a, __m512d b, __m512d t) {
+    __mmask8 ok = _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(a, b)), t, _CMP_LE_OQ);
+    return (__mmask8)(ok | nan_pair_avx512(a, b) | _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)) != 0xFF;
+}
+
+__attribute__((target("avx2"))) static inline int rel_bad_avx2(__m256d a, __m256d b, __m256d t) {
+    __m256d sign = _mm256_set1_pd(-0.0), d = _mm256_andnot_pd(sign, _mm256_sub_pd(a, b));
+    __m256d m = _mm256_mul_pd(t, _mm256_max_pd(_mm256_andnot_pd(sign, a), _mm256_andnot_pd(sign, b)));
+    __m256d ok = _mm256_and_pd(_mm256_cmp_pd(d, m, _CMP_LE_OQ),
+                               _mm256_cmp_pd(d, _mm256_set1_pd(INFINITY), _CMP_LT_OQ));
+    return _mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(ok, nan_pair_avx2(a, b)),
+                                           _mm256_cmp_pd(a, b, _CMP_EQ_OQ))) != 0xF;
+}
+
+__attribute__((target("avx512f"))) static inline int rel_bad_avx512(__m512d a, __m512d b, __m512d t) {
+    __m512d d = _mm512_abs_pd(_mm512_sub_pd(a, b));
+    __m512d m = _mm512_mul_pd(t, _mm512_max_pd(_mm512_abs_pd(a), _mm512_abs_pd(b)));
+    __mmask8 ok = _mm512_cmp_pd_mask(d, m, _CMP_LE_OQ) &
+                  _mm512_cmp_pd_mask(d, _mm512_set1_pd(INFINITY), _CMP_LT_OQ);
+    return (__mmask8)(ok | nan_pair_avx512(a, b) | _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)) != 0xFF;
+}
+
+// Упорядоченные целые как в eq_ulp_scalar; |d| > t проверяется двумя знаковыми сравнениями.
+__attribute__((target("avx2"))) static inline __m256i ordered_avx2(__m256d x) {
+    __m256i bits = _mm256_castpd_si256(x);
+    __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), bits);
+    return _mm256_xor_si256(bits, _mm256_and_si256(negative, _mm256_set1_epi64x(INT64_MAX)));
+}
+
+__attribute__((target("avx2"))) static inline int ulp_bad_avx2(__m256d a, __m256d b, __m256i t) {
+    __m256i d = _mm256_sub_epi64(ordered_avx2(a), ordered_avx2(b));
+    __m256i far = _mm256_or_si256(_mm256_cmpgt_epi64(d, t),
+                                  _mm256_cmpgt_epi64(_mm256_sub_epi64(_mm256_setzero_si256(), t), d));
+    __m256d bad = _mm256_or_pd(_mm256_castsi256_pd(far), _mm256_cmp_pd(a, b, _CMP_UNORD_Q));
+    __m256d ok = _mm256_or_pd(nan_pair_avx2(a, b), _mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+    return (_mm256_movemask_pd(bad) & ~_mm256_movemask_pd(ok)) != 0;
+}
+
+__attribute__((target("avx512f"))) static inline int ulp_bad_avx512(__m512d a, __m512d b, __m512i t) {
+    __m512i x = _mm512_castpd_si512(a), y = _mm512_castpd_si512(b), max = _mm512_set1_epi64(INT64_MAX);
+    x = _mm512_mask_xor_epi64(x, _mm512_cmplt_epi64_mask(x, _mm512_setzero_si512()), x, max);
+    y = _mm512_mask_xor_epi64(y, _mm512_cmplt_epi64_mask(y, _mm512_setzero_si512()), y, max);
+    __mmask8 close = _mm512_cmple_epu64_mask(_mm512_abs_epi64(_mm512_sub_epi64(x, y)), t) &
+                     _mm512_cmp_pd_mask(a, b, _CMP_ORD_Q);
+    return (__mmask8)(close | nan_pair_avx512(a, b) | _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)) != 0xFF;
+}
+
+EQ_MODE_KERNEL(eq_abs, sse2, "sse2", __m128d, double, 2, _mm_loadu_pd, _mm_set1_pd, abs_bad_sse2)
+EQ_MODE_KERNEL(eq_abs, avx2, "avx2", __m256d, double, 4, _mm256_loadu_pd, _mm256_set1_pd, abs_bad_avx2)
+EQ_MODE_KERNEL(eq_abs, avx512, "avx512f", __m512d, double, 8, _mm512_loadu_pd, _mm512_set1_pd,
+               abs_bad_avx512)
+EQ_MODE_KERNEL(eq_rel, sse2, "sse2", __m128d, double, 2, _mm_loadu_pd, _mm_set1_pd, rel_bad_sse2)
+EQ_MODE_KERNEL(eq_rel, avx2, "avx2", __m256d, double, 4, _mm256_loadu_pd, _mm256_set1_pd, rel_bad_avx2)
+EQ_MODE_KERNEL(eq_rel, avx512, "avx512f", __m512d, double, 8, _mm512_loadu_pd, _mm512_set1_pd,
+               rel_bad_avx512)
+EQ_MODE_KERNEL(eq_ulp, avx2, "avx2", __m256i, int64_t, 4, _mm256_loadu_pd, _mm256_set1_epi64x,
+               ulp_bad_avx2)
+EQ_MODE_KERNEL(eq_ulp, avx512, "avx512f", __m512i, int64_t, 8, _mm512_loadu_pd, _mm512_set1_epi64,
+               ulp_bad_avx512)
+// В SSE2 нет сравнения 64-битных целых (оно появилось в SSE4.2).
+#define eq_ulp_sse2 eq_ulp_scalar
+
+// Полоса хеша занимает S21_HASH_LANES / W векторов.
+#define HASH_KERNEL(SUFFIX, TARGET, VEC, W, LOAD, STORE, SET1, ADD, XOR, MUL32, SRLI) \
+    __attribute__((target(TARGET))) static void hash_##SUFFIX(uint64_t *acc, const double *a, \
+                                                              size_t stripes, size_t first) { \
+        VEC va[S21_HASH_LANES / W], vk[S21_HASH_LANES / W], step = SET1((int64_t)HASH_STEP); \
+        for (int v = 0; v < S21_HASH_LANES / W; v++) { \
+            va[v] = LOAD(acc + v * W); \
+            vk[v] = ADD(LOAD(hash_secret + v * W), SET1((int64_t)(first * HASH_STEP))); \
+        } \
+        for (size_t s = 0; s < stripes; s++) { \
+            for (int v = 0; v < S21_HASH_LANES / W; v++) { \
+                VEC x = LOAD(a + s * S21_HASH_LANES + v * W), k = XOR(x, vk[v]); \
+                va[v] = ADD(va[v], ADD(x, MUL32(k, SRLI(k, 32)))); \
+                vk[v] = ADD(vk[v], step); \
+            } \
+        } \
+        for (int v = 0; v < S21_HASH_LANES / W; v++) \
+            STORE(acc + v * W, va[v]); \
+    }
+
+#define SSE2_LOADI(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define SSE2_STOREI(p, v) _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define AVX2_LOADI(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define AVX2_STOREI(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+
+HASH_KERNEL(sse2, "sse2", __m128i, 2, SSE2_LOADI, SSE2_STOREI, _mm_set1_epi64x, _mm_add_epi64,
+            _mm_xor_si128, _mm_mul_epu32, _mm_srli_epi64)
+HASH_KERNEL(avx2, "avx2", __m256i, 4, AVX2_LOADI, AVX2_STOREI, _mm256_set1_epi64x, _mm256_add_epi64,
+            _mm256_xor_si256, _mm256_mul_epu32, _mm256_srli_epi64)
+HASH_KERNEL(avx512, "avx512f", __m512i, 8, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi64,
+            _mm512_add_epi64, _mm512_xor_si512, _mm512_mul_epu32, _mm512_srli_epi64)
+
+// Ядра одного уровня отличаются только типом вектора и интринсиками,
+// поэтому генерируются одним макросом. Хвост добирается скалярной версией.
+#define SIMD_KERNELS(SUFFIX, TARGET, VEC, W, LOAD, STORE, SET1, ADD, SUB, MUL, MADD, ABS_GT_ANY) \
+    __attribute__((target(TARGET))) static void add_##SUFFIX(double *r, const double *a, \
+                                                             const double *b, size_t n) { \
+        size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            STORE(r + i, ADD(LOAD(a + i), LOAD(b + i))); \
+        add_scalar(r + i, a + i, b + i, n - i); \
+    } \
+    __attribute__((target(TARGET))) static void sub_##SUFFIX(double *r, const double *a, \
+                                                             const double *b, size_t n) { \
+        size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            STORE(r + i, SUB(LOAD(a + i), LOAD(b + i))); \
+        sub_scalar(r + i, a + i, b + i, n - i); \
+    } \
+    __attribute__((target(TARGET))) static void scale_##SUFFIX(double *r, const double *a, \
+                                                               double s, size_t n) { \
+        VEC vs = SET1(s); \
+        size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            STORE(r + i, MUL(LOAD(a + i), vs)); \
+        scale_scalar(r + i, a + i, s, n - i); \
+    } \
+    __attribute__((target(TARGET))) static void axpy_##SUFFIX(double *y, const double *x, \
+                                                              double alpha, size_t n) { \
+        VEC va = SET1(alpha); \
+        size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            STORE(y + i, MADD(va, LOAD(x + i), LOAD(y + i))); \
+        axpy_scalar(y + i, x + i, alpha, n - i); \
+    } \
+    __attribute__((target(TARGET))) static int eq_##SUFFIX(const double *a, const double *b, \
+                                                           size_t n, double eps) { \
+        VEC ve = SET1(eps); \
+        int ret = 1; \
+        size_t i = 0; \
+        for (; i + W <= n && ret; i += W) \
+            if (ABS_GT_ANY(SUB(LOAD(a + i), LOAD(b + i)), ve)) \
+                ret = 0; \
+        return ret && eq_scalar(a + i, b + i, n - i, eps); \
+    } \
+    static const simd_kernels_t SUFFIX##_kernels = {add_##SUFFIX, sub_##SUFFIX, scale_##SUFFIX, \
+                                                    axpy_##SUFFIX, axpyf_##SUFFIX, eq_##SUFFIX, \
+                                                    eq_abs_##SUFFIX, eq_rel_##SUFFIX, eq_ulp_##SUFFIX, \
+                                                    transpose_##SUFFIX, hash_##SUFFIX};
+
+#define SSE2_MADD(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define SSE2_ABS_GT_ANY(d, e) \
+    _mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), d), e))
+#define AVX2_ABS_GT_ANY(d, e) \
+    _mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), d), e, _CMP_GT_OQ))
+#define AVX512_ABS_GT_ANY(d, e) \
+    _mm512_cmp_pd_mask(_mm512_abs_pd(d), e, _CMP_GT_OQ)
+
+SIMD_KERNELS(sse2, "sse2", __m128d, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd,
+             _mm_add_pd, _mm_sub_pd, _mm_mul_pd, SSE2_MADD, SSE2_ABS_GT_ANY)
+SIMD_KERNELS(avx2, "avx2,fma", __m256d, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd,
+             _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, _mm256_fmadd_pd, AVX2_ABS_GT_ANY)
+SIMD_KERNELS(avx512, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd,
+             _mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, _mm512_fmadd_pd, AVX512_ABS_GT_ANY)
+#endif
+
+static const simd_kernels_t *kernels_for(int level) {
+    const simd_kernels_t *k = &scalar_kernels;
+#if SIMD_X86
+    if (level == S21_SIMD_SSE2)
+        k = &sse2_kernels;
+    else if (level == S21_SIMD_AVX2)
+        k = &avx2_kernels;
+    else if (level == S21_SIMD_AVX512)
+        k = &avx512_kernels;
+#endif
+    return k;
+}
@@ -0,0 +1,324 @@
+#include "s21_matrix.h"
+
+// Строк CSR на одну задачу пула потоков в SpMM; меньшие произведения считаются в вызывающем потоке.
+#ifndef SPARSE_TASK_ROWS
+#define SPARSE_TASK_ROWS 64
+#endif
+#ifndef SPARSE_PARALLEL_MIN
+#define SPARSE_PARALLEL_MIN (1L << 20)
+#endif
+
+typedef struct sparse_job {
+    const s21_sparse_t *A;
+    const double       *B;
+    double             *C;
+    int                n;
+} sparse_job_t;
+
+static size_t sparse_bytes(int nnz, int major);
+static int sparse_major(const s21_sparse_t *A);
+static int sparse_minor(const s21_sparse_t *A);
+static int sparse_is_empty(const s21_sparse_t *A);
+static void sparse_reorder(const s21_sparse_t *A, s21_sparse_t *result);
+static int sparse_mult_task(void *arg, int task);
+
+// Один блок: значения, затем индексы и смещения; nnz - ёмкость, offsets[major] - занято.
+int s21_sparse_create(int rows, int columns, int nnz, int format, s21_sparse_t *result) {
+    int ret = 0;
+    result->values = NULL;
+    result->indices = NULL;
+    result->offsets = NULL;
+    result->rows = 0;
+    result->columns = 0;
+    result->nnz = 0;
+    result->format = format;
+
+    if (rows < 1 || columns < 1 || nnz < 0 || (format != S21_CSR && format != S21_CSC)) {
+        ret = 1;
+    } else {
+        int major = format == S21_CSR ? rows : columns;
+        size_t bytes = sparse_bytes(nnz, major);
+        char *mem = (char *)calloc(1, bytes);
+        if (mem == NULL) {
+            ret = 2;
+        } else {
+            STATS_ALLOC(bytes);
+            result->values = (double *)mem;
+            result->indices = (int *)(mem + (size_t)nnz * sizeof(double));
+            result->offsets = result->indices + nnz;
+            result->rows = rows;
+            result->columns = columns;
+            result->nnz = nnz;
+        }
+    }
+
+    return ret;
+}
+
+void s21_sparse_remove(s21_sparse_t *A) {
+    if (A->values != NULL)
+        STATS_FREE(sparse_bytes(A->nnz, sparse_major(A)));
+    free(A->values);
+    A->values = NULL;
+    A->indices = NULL;
+    A->offsets = NULL;
+    A->rows = 0;
+    A->columns = 0;
+    A->nnz = 0;
+}
+
+// Сохраняются только ненулевые элементы; первый проход считает их, второй раскладывает.
+int s21_sparse_from_matrix(matrix_t *A, int format, s21_sparse_t *result) {
+    int ret = 0;
+    size_t nnz = 0;
+
+    if (matrix_is_empty(A) || (format != S21_CSR && format != S21_CSC)) {
+        ret = 1;
+    } else {
+        int rs, cs;
+        matrix_strides(A, &rs, &cs);
+        const double *a = A->matrix[0];
+        for (size_t i = 0; i < (size_t)A->rows * A->columns; i++)
+            nnz += a[i] != 0;
+        if (nnz > INT_MAX || s21_sparse_create(A->rows, A->columns, (int)nnz, format, result) != 0) {
+            ret = 2;
+        } else {
+            int major = sparse_major(result), minor = sparse_minor(result), k = 0;
+            // Шаги по главной и второстепенной осям формата.
+            size_t ms = format == S21_CSR ? rs : cs, ns = format == S21_CSR ? cs : rs;
+            for (int i = 0; i < major; i++) {
+                result->offsets[i] = k;
+                for (int j = 0; j < minor; j++) {
+                    double v = a[i * ms + j * ns];
+                    if (v != 0) {
+                        result->values[k] = v;
+                        result->indices[k++] = j;
+                    }
+                }
+            }
+            result->offsets[major] = k;
+        }
+    }
+
+    return ret;
+}
+
+int s21_sparse_to_matrix(const s21_sparse_t *A, matrix_t *result) {
+    int ret = 0;
+
+    if (sparse_is_empty(A)) {
+        ret = 1;
+    } else if (s21_create_matrix(A->rows, A->columns, result) != 0) {
+        ret = 2;
+    } else {
+        for (int i = 0; i < sparse_major(A); i++)
+            for (int k = A->offsets[i]; k < A->offsets[i + 1]; k++) {
+                if (A->format == S21_CSR)
+                    result->matrix[i][A->indices[k]] = A->values[k];
+                else
+                    result->matrix[A->indices[k]][i] = A->values[k];
+            }
+    }
+
+    return ret;
+}
+
+// Та же матрица в другом формате: подсчёт элементов по второстепенной оси и раскладка, O(nnz).
+int s21_sparse_convert(const s21_sparse_t *A, int format, s21_sparse_t *result) {
+    int ret = 0;
+
+    if (sparse_is_empty(A) || (format != S21_CSR && format != S21_CSC)) {
+        ret = 1;
+    } else if (s21_sparse_create(A->rows, A->columns, A->offsets[sparse_major(A)], format, result) != 0) {
+        ret = 2;
+    } else if (format == A->format) {
+        memcpy(result->values, A->values, sizeof(double) * result->nnz);
+        memcpy(result->indices, A->indices, sizeof(int) * result->nnz);
+        memcpy(result->offsets, A->offsets, sizeof(int) * (sparse_major(A) + 1));
+    } else {
+        sparse_reorder(A, result);
+    }
+
+    return ret;
+}
+
+// CSR матрицы A - это CSC матрицы A^T, поэтому транспонирование - та же перестановка в другом формате.
+int s21_sparse_transpose(const s21_sparse_t *A, s21_sparse_t *result) {
+    int ret = 0;
+
+    if (sparse_is_empty(A)) {
+        ret = 1;
+    } else if (s21_sparse_create(A->columns, A->rows, A->offsets[sparse_major(A)], A->format, result) != 0) {
+        ret = 2;
+    } else {
+        s21_sparse_t T = *A;
+        T.rows = A->columns;
+        T.columns = A->rows;
+        T.format = A->format == S21_CSR ? S21_CSC : S21_CSR;
+        sparse_reorder(&T, result);
+    }
+
+    return ret;
+}
+
+// Результат в формате A; B другого формата сначала переводится в него.
+int s21_sparse_sum(const s21_sparse_t *A, const s21_sparse_t *B, s21_sparse_t *result) {
+    STATS_BEGIN();
+    int ret = 0;
+    s21_sparse_t tmp = {NULL, NULL, NULL, 0, 0, 0, 0};
+
+    if (sparse_is_empty(A) || sparse_is_empty(B)) {
+        ret = 1;
+    } else if (A->rows != B->rows || A->columns != B->columns) {
+        ret = 2;
+    } else if (B->format != A->format && s21_sparse_convert(B, A->format, &tmp) != 0) {
+        ret = 2;
+    } else {
+        const s21_sparse_t *b = B->format == A->format ? B : &tmp;
+        int major = sparse_major(A);
+        size_t nnz = 0;
+        // Символьный проход: размер объединения индексов каждой строки (столбца).
+        for (int i = 0; i < major; i++) {
+            int p = A->offsets[i], q = b->offsets[i];
+            while (p < A->offsets[i + 1] || q < b->offsets[i + 1]) {
+                int ia = p < A->offsets[i + 1] ? A->indices[p] : INT_MAX;
+                int ib = q < b->offsets[i + 1] ? b->indices[q] : INT_MAX;
+                p += ia <= ib;
+                q += ib <= ia;
+                nnz++;
+            }
+        }
+        if (nnz > INT_MAX || s21_sparse_create(A->rows, A->columns, (int)nnz, A->format, result) != 0) {
+            ret = 2;
+        } else {
+            int k = 0;
+            for (int i = 0; i < major; i++) {
+                int p = A->offsets[i], q = b->offsets[i];
+                result->offsets[i] = k;
+                while (p < A->offsets[i + 1] || q < b->offsets[i + 1]) {
+                    int ia = p < A->offsets[i + 1] ? A->indices[p] : INT_MAX;
+                    int ib = q < b->offsets[i + 1] ? b->indices[q] : INT_MAX;
+                    result->indices[k] = ia < ib ? ia : ib;
+                    result->values[k++] = (ia <= ib ? A->values[p++] : 0) + (ib <= ia ? b->values[q++] : 0);
+                }
+            }
+            result->offsets[major] = k;
+        }
+    }
+    s21_sparse_remove(&tmp);
+
+    STATS_END(sparse_sum, ret ? 0 : (double)result->nnz);
+    return ret;
+}
+
+// y = A * x, x - columns элементов, y - rows элементов.
+int s21_sparse_mult_vector(const s21_sparse_t *A, const double *x, double *y) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (sparse_is_empty(A) || x == NULL || y == NULL) {
+        ret = 1;
+    } else if (A->format == S21_CSR) {
+        for (int i = 0; i < A->rows; i++) {
+            double sum = 0;
+            for (int k = A->offsets[i]; k < A->offsets[i + 1]; k++)
+                sum += A->values[k] * x[A->indices[k]];
+            y[i] = sum;
+        }
+    } else {
+        memset(y, 0, sizeof(double) * A->rows);
+        for (int j = 0; j < A->columns; j++)
+            for (int k = A->offsets[j]; k < A->offsets[j + 1]; k++)
+                y[A->indices[k]] += A->values[k] * x[j];
+    }
+
+    STATS_END(sparse_mult_vector, ret ? 0 : 2.0 * A->offsets[sparse_major(A)]);
+    return ret;
+}
+
+// Плотный результат rows x B->columns: каждый ненулевой a_ik добавляет a_ik * B[k] к строке i.
+int s21_sparse_mult_matrix(const s21_sparse_t *A, matrix_t *B, matrix_t *result) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (sparse_is_empty(A) || matrix_is_empty(B)) {
+        ret = 1;
+    } else if (A->columns != B->rows) {
+        ret = 2;
+    } else {
+        double *tmp = NULL;
+        const double *b = oriented_data(B, 0, &tmp);
+        if (b == NULL || s21_create_matrix(A->rows, B->columns, result) != 0) {
+            ret = 2;
+        } else if (A->format == S21_CSR) {
+            sparse_job_t job = {A, b, result->matrix[0], B->columns};
+            int tasks = (A->rows + SPARSE_TASK_ROWS - 1) / SPARSE_TASK_ROWS;
+            if (2.0 * A->offsets[A->rows] * B->columns < SPARSE_PARALLEL_MIN) {
+                for (int t = 0; t < tasks; t++)
+                    sparse_mult_task(&job, t);
+            } else {
+                ret = parallel_for(tasks, sparse_mult_task, &job);
+            }
+        } else {
+            int n = B->columns;
+            for (int j = 0; j < A->columns; j++)
+                for (int k = A->offsets[j]; k < A->offsets[j + 1]; k++)
+                    vec_axpy(result->matrix[A->indices[k]], b + (size_t)j * n, A->values[k], n);
+        }
+        scratch_free(tmp);
+    }
+
+    STATS_END(sparse_mult_matrix, ret ? 0 : 2.0 * A->offsets[sparse_major(A)] * B->columns);
+    return ret;
+}
+
+static int sparse_mult_task(void *arg, int task) {
+    sparse_job_t *job = (sparse_job_t *)arg;
+    const s21_sparse_t *A = job->A;
+    int last = (task + 1) * SPARSE_TASK_ROWS < A->rows ? (task + 1) * SPARSE_TASK_ROWS : A->rows;
+
+    for (int i = task * SPARSE_TASK_ROWS; i < last; i++)
+        for (int k = A->offsets[i]; k < A->offsets[i + 1]; k++)
+            vec_axpy(job->C + (size_t)i * job->n, job->B + (size_t)A->indices[k] * job->n, A->values[k],
+                     job->n);
+
+    return 0;
+}
+
+// Перекладывает A в формат result (другой), сохраняя порядок индексов внутри строк и столбцов.
+static void sparse_reorder(const s21_sparse_t *A, s21_sparse_t *result) {
+    int major = sparse_major(A), minor = sparse_minor(A);
+    int *next = result->offsets;
+
+    for (int k = 0; k < A->offsets[major]; k++)
+        next[A->indices[k] + 1]++;
+    for (int j = 0; j < minor; j++)
+        next[j + 1] += next[j];
+    // next[j] - позиция записи; после раскладки смещения сдвинуты на один элемент вперёд.
+    for (int i = 0; i < major; i++)
+        for (int k = A->offsets[i]; k < A->offsets[i + 1]; k++) {
+            int pos = next[A->indices[k]]++;
+            result->indices[pos] = i;
+            result->values[pos] = A->values[k];
+        }
+    for (int j = minor; j > 0; j--)
+        next[j] = next[j - 1];
+    next[0] = 0;
+}
+
+static size_t sparse_bytes(int nnz, int major) {
+    return (size_t)nnz * (sizeof(double) + sizeof(int)) + ((size_t)major + 1) * sizeof(int);
+}
+
+static int sparse_major(const s21_sparse_t *A) {
+    return A->format == S21_CSR ? A->rows : A->columns;
+}
+
+static int sparse_minor(const s21_sparse_t *A) {
+    return A->format == S21_CSR ? A->columns : A->rows;
+}
+
+static int sparse_is_empty(const s21_sparse_t *A) {
+    return A == NULL || A->values == NULL || A->rows < 1 || A->columns < 1 ||
+           (A->format != S21_CSR && A->format != S21_CSC);
+}
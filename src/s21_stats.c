@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "s21_matrix.h"
+
+// Счётчики общие для всех потоков, поэтому меняются только атомарными операциями.
+static s21_stats_t stats;
+
+#define STATS_NAME(name) #name,
+static const char *const stats_names[S21_STAT_COUNT] = {S21_STATS_FUNCTIONS(STATS_NAME)};
+
+int s21_stats_snapshot(s21_stats_t *result) {
+    int ret = 0;
+    memset(result, 0, sizeof(*result));
+
+#ifdef S21_STATS
+    for (int i = 0; i < S21_STAT_COUNT; i++) {
+        result->functions[i].calls = __atomic_load_n(&stats.functions[i].calls, __ATOMIC_RELAXED);
+        result->functions[i].ns = __atomic_load_n(&stats.functions[i].ns, __ATOMIC_RELAXED);
+        result->functions[i].flops = __atomic_load_n(&stats.functions[i].flops, __ATOMIC_RELAXED);
+    }
+    result->bytes_allocated = __atomic_load_n(&stats.bytes_allocated, __ATOMIC_RELAXED);
+    result->bytes_freed = __atomic_load_n(&stats.bytes_freed, __ATOMIC_RELAXED);
+    result->live_matrices = __atomic_load_n(&stats.live_matrices, __ATOMIC_RELAXED);
+    result->peak_live_matrices = __atomic_load_n(&stats.peak_live_matrices, __ATOMIC_RELAXED);
+    result->enabled = 1;
+#else
+    ret = 1;
+#endif
+
+    return ret;
+}
+
+// Живые матрицы не сбрасываются: они всё ещё существуют, пик начинается с текущего числа.
+void s21_stats_reset(void) {
+    for (int i = 0; i < S21_STAT_COUNT; i++) {
+        __atomic_store_n(&stats.functions[i].calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.functions[i].ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.functions[i].flops, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&stats.bytes_allocated, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.bytes_freed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.peak_live_matrices, __atomic_load_n(&stats.live_matrices, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+}
+
+int s21_stats_dump_json(FILE *out) {
+    s21_stats_t s;
+    s21_stats_snapshot(&s);
+
+    fprintf(out, "{\"enabled\": %s, \"bytes_allocated\": %llu, \"bytes_freed\": %llu, "
+                 "\"live_matrices\": %lld, \"peak_live_matrices\": %lld, \"functions\": {",
+            s.enabled ? "true" : "false", (unsigned long long)s.bytes_allocated,
+            (unsigned long long)s.bytes_freed, (long long)s.live_matrices, (long long)s.peak_live_matrices);
+    for (int i = 0; i < S21_STAT_COUNT; i++)
+        fprintf(out, "%s\"%s\": {\"calls\": %llu, \"ns\": %llu, \"flops\": %llu}", i ? ", " : "",
+                stats_names[i], (unsigned long long)s.functions[i].calls,
+                (unsigned long long)s.functions[i].ns, (unsigned long long)s.functions[i].flops);
+    fprintf(out, "}}\n");
+
+    return ferror(out) ? 2 : 0;
+}
+
+const char *s21_stats_name(int id) {
+    return id >= 0 && id < S21_STAT_COUNT ? stats_names[id] : NULL;
+}
+
+uint64_t stats_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void stats_record(int id, uint64_t start, double flops) {
+    s21_stats_entry_t *e = &stats.functions[id];
+
+    __atomic_fetch_add(&e->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->ns, stats_clock() - start, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->flops, (uint64_t)flops, __ATOMIC_RELAXED);
+}
+
+void stats_alloc(size_t bytes) {
+    __atomic_fetch_add(&stats.bytes_allocated, bytes, __ATOMIC_RELAXED);
+}
+
+void stats_free(size_t bytes) {
+    __atomic_fetch_add(&stats.bytes_freed, bytes, __ATOMIC_RELAXED);
+}
+
+void stats_live(int delta) {
+    int64_t live = __atomic_add_fetch(&stats.live_matrices, delta, __ATOMIC_RELAXED);
+    int64_t peak = __atomic_load_n(&stats.peak_live_matrices, __ATOMIC_RELAXED);
+
+    while (live > peak && !__atomic_compare_exchange_n(&stats.peak_live_matrices, &peak, live, 1,
+                                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
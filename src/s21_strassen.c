@@ -0,0 +1,145 @@
+#include "s21_matrix.h"
+
+// Порог по умолчанию: блоки, у которых меньшая сторона не больше порога, умножаются gemm_blocked.
+#ifndef STRASSEN_CUTOFF
+#define STRASSEN_CUTOFF 512
+#endif
+
+// Меняются из любого потока во время умножений, поэтому читаются и пишутся атомарно, как max_bytes кэша.
+static int mult_policy = S21_MULT_CLASSIC;
+static int strassen_cutoff = STRASSEN_CUTOFF;
+
+static int winograd(int m, int n, int k, const double *A, int lda, const double *B, int ldb,
+                    double *C, int ldc, double *ws, int cutoff);
+static int classic(int m, int n, int k, const double *A, int lda, const double *B, int ldb,
+                   double *C, int ldc);
+static void block_op(vec_op_fn op, int m, int n, const double *X, int ldx, const double *Y, int ldy,
+                     double *Z, int ldz);
+static size_t workspace_size(int m, int n, int k, int cutoff);
+
+int s21_set_mult_policy(int policy, int cutoff) {
+    int ret = 0;
+
+    if ((policy != S21_MULT_CLASSIC && policy != S21_MULT_STRASSEN) || cutoff < 0) {
+        ret = 1;
+    } else {
+        __atomic_store_n(&strassen_cutoff, cutoff > 0 ? cutoff : STRASSEN_CUTOFF, __ATOMIC_RELAXED);
+        __atomic_store_n(&mult_policy, policy, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+int s21_get_mult_policy(void) {
+    return __atomic_load_n(&mult_policy, __ATOMIC_RELAXED);
+}
+
+int strassen_applies(int m, int n, int k) {
+    int c = __atomic_load_n(&strassen_cutoff, __ATOMIC_RELAXED);
+    return s21_get_mult_policy() == S21_MULT_STRASSEN && m > c && n > c && k > c;
+}
+
+/*
+ * C = A * B по Штрассену-Винограду: 7 умножений половинного размера и 15 сложений на уровне.
+ * Все временные блоки берутся из одного рабочего буфера, выделенного здесь заранее.
+ * Транспонированные A и B один раз копируются в обычную ориентацию. Порог читается один раз:
+ * размер буфера и глубина рекурсии должны считаться по одному значению.
+ */
+int strassen_mult(matrix_t *A, matrix_t *B, matrix_t *result) {
+    int ret = 0;
+    double *ta = NULL, *tb = NULL;
+    const double *a = oriented_data(A, 0, &ta);
+    const double *b = oriented_data(B, 0, &tb);
+    int cutoff = __atomic_load_n(&strassen_cutoff, __ATOMIC_RELAXED);
+    double *ws = scratch_alloc(workspace_size(A->rows, B->columns, A->columns, cutoff));
+
+    if (a == NULL || b == NULL || ws == NULL)
+        ret = 2;
+    else
+        ret = winograd(A->rows, B->columns, A->columns, a, A->columns, b, B->columns, result->matrix[0],
+                       result->columns, ws, cutoff);
+    scratch_free(ta);
+    scratch_free(tb);
+    scratch_free(ws);
+
+    return ret;
+}
+
+/*
+ * Чётная часть делится на четверти, нечётные последние строка, столбец и слагаемое по k
+ * (отщепление) досчитываются обычным умножением. Порядок шагов позволяет обойтись тремя
+ * временными блоками SA, TB, P; остальные промежуточные суммы лежат в четвертях C.
+ */
+static int winograd(int m, int n, int k, const double *A, int lda, const double *B, int ldb,
+                    double *C, int ldc, double *ws, int cutoff) {
+    int ret = 0;
+
+    if (m <= cutoff || n <= cutoff || k <= cutoff) {
+        ret = classic(m, n, k, A, lda, B, ldb, C, ldc);
+    } else {
+        int h = m / 2, w = n / 2, d = k / 2;
+        const double *A11 = A, *A12 = A + d, *A21 = A + (size_t)h * lda, *A22 = A21 + d;
+        const double *B11 = B, *B12 = B + w, *B21 = B + (size_t)d * ldb, *B22 = B21 + w;
+        double *C11 = C, *C12 = C + w, *C21 = C + (size_t)h * ldc, *C22 = C21 + w;
+        double *SA = ws, *TB = SA + (size_t)h * d, *P = TB + (size_t)d * w, *next = P + (size_t)h * w;
+
+        block_op(vec_sub, h, d, A11, lda, A21, lda, SA, d);                     // S3
+        block_op(vec_sub, d, w, B22, ldb, B12, ldb, TB, w);                     // T3
+        ret |= winograd(h, w, d, SA, d, TB, w, C21, ldc, next, cutoff);        // C21 = P7
+        block_op(vec_add, h, d, A21, lda, A22, lda, SA, d);                     // S1
+        block_op(vec_sub, d, w, B12, ldb, B11, ldb, TB, w);                     // T1
+        ret |= winograd(h, w, d, SA, d, TB, w, C22, ldc, next, cutoff);        // C22 = P5
+        block_op(vec_sub, h, d, SA, d, A11, lda, SA, d);                        // S2
+        block_op(vec_sub, d, w, B22, ldb, TB, w, TB, w);                        // T2
+        ret |= winograd(h, w, d, SA, d, TB, w, C12, ldc, next, cutoff);        // C12 = P6
+        ret |= winograd(h, w, d, A11, lda, B11, ldb, P, w, next, cutoff);      // P = P1
+        block_op(vec_add, h, w, C12, ldc, P, w, C12, ldc);                      // U2 = P1 + P6
+        block_op(vec_add, h, w, C21, ldc, C12, ldc, C21, ldc);                  // U3 = U2 + P7
+        block_op(vec_add, h, w, C12, ldc, C22, ldc, C12, ldc);                  // U4 = U2 + P5
+        block_op(vec_add, h, w, C22, ldc, C21, ldc, C22, ldc);                  // C22 = U3 + P5
+        block_op(vec_sub, h, d, A12, lda, SA, d, SA, d);                        // S4
+        ret |= winograd(h, w, d, SA, d, B22, ldb, C11, ldc, next, cutoff);     // C11 = P3
+        block_op(vec_add, h, w, C12, ldc, C11, ldc, C12, ldc);                  // C12 = U4 + P3
+        block_op(vec_sub, d, w, TB, w, B21, ldb, TB, w);                        // T4
+        ret |= winograd(h, w, d, A22, lda, TB, w, C11, ldc, next, cutoff);     // C11 = P4
+        block_op(vec_sub, h, w, C21, ldc, C11, ldc, C21, ldc);                  // C21 = U3 - P4
+        ret |= winograd(h, w, d, A12, lda, B21, ldb, C11, ldc, next, cutoff);  // C11 = P2
+        block_op(vec_add, h, w, C11, ldc, P, w, C11, ldc);                      // C11 = P1 + P2
+
+        if (k % 2 != 0)
+            ret |= gemm_blocked(2 * h, 2 * w, 1, 1, A + k - 1, lda, 1, B + (size_t)(k - 1) * ldb, ldb, 1,
+                                C, ldc);
+        if (n % 2 != 0)
+            ret |= classic(2 * h, 1, k, A, lda, B + n - 1, ldb, C + n - 1, ldc);
+        if (m % 2 != 0)
+            ret |= classic(1, n, k, A + (size_t)(m - 1) * lda, lda, B, ldb, C + (size_t)(m - 1) * ldc, ldc);
+    }
+
+    return ret != 0 ? 2 : 0;
+}
+
+// C = A * B: gemm_blocked только прибавляет, поэтому блок C сначала обнуляется.
+static int classic(int m, int n, int k, const double *A, int lda, const double *B, int ldb,
+                   double *C, int ldc) {
+    for (int y = 0; y < m; y++)
+        memset(C + (size_t)y * ldc, 0, (size_t)n * sizeof(double));
+
+    return gemm_blocked(m, n, k, 1, A, lda, 1, B, ldb, 1, C, ldc);
+}
+
+// Z = X op Y построчно для блоков со своими шагами строк; Z может совпадать с X или Y.
+static void block_op(vec_op_fn op, int m, int n, const double *X, int ldx, const double *Y, int ldy,
+                     double *Z, int ldz) {
+    for (int y = 0; y < m; y++)
+        op(Z + (size_t)y * ldz, X + (size_t)y * ldx, Y + (size_t)y * ldy, (size_t)n);
+}
+
+// SA, TB и P каждого уровня; уровни ниже используют место за ними.
+static size_t workspace_size(int m, int n, int k, int cutoff) {
+    size_t size = 0;
+
+    for (; m > cutoff && n > cutoff && k > cutoff; m /= 2, n /= 2, k /= 2)
+        size += (size_t)(m / 2) * (k / 2) + (size_t)(k / 2) * (n / 2) + (size_t)(m / 2) * (n / 2);
+
+    return size > 0 ? size : 1;
+}
@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L
+#include "s21_matrix.h"
+
+// Буфер записи и наибольшая длина одного числа (%.17g с порядком).
+#define TEXT_BUFFER (1 << 16)
+#define TEXT_NUMBER 32
+// Больше 19 цифр не помещается в uint64_t.
+#define TEXT_DIGITS 19
+#define TEXT_EXACT  (1ull << 53)
+
+typedef struct text_values {
+    double  *data;
+    size_t  count;
+    size_t  capacity;
+} text_values_t;
+
+// Степени 10, которые long double с 64-битной мантиссой хранит точно.
+static const long double text_pow10l[] = {1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,
+                                          1e8L,  1e9L,  1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L,
+                                          1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L,
+                                          1e24L, 1e25L, 1e26L, 1e27L};
+
+// Степени 10, которые double хранит точно.
+static const double text_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static char text_separator(const s21_text_options_t *opt);
+static int text_format(char *out, double value, int precision);
+static int text_shortest(char *out, double value);
+static int text_render(char *out, int negative, uint64_t digits, int exponent);
+static int text_parse_row(char *s, char separator, text_values_t *values);
+static char *text_parse_double(char *s, double *value);
+static int text_is_blank(char c, char separator);
+
+/*
+ * Числа пишутся в буфер и сбрасываются в f большими кусками. Без precision каждое число
+ * записывается кратчайшей строкой из 15-17 значащих цифр, которая читается обратно точно.
+ */
+int s21_write_matrix_text(FILE *f, matrix_t *A, const s21_text_options_t *opt) {
+    int ret = 0;
+    char *buf = NULL;
+
+    if (matrix_is_empty(A) || f == NULL || text_separator(opt) == 0 ||
+        (opt != NULL && (opt->precision < 0 || opt->precision > 17))) {
+        ret = 1;
+    } else if ((buf = (char *)malloc(TEXT_BUFFER)) == NULL) {
+        ret = 2;
+    } else {
+        int rs, cs, precision = opt != NULL ? opt->precision : 0;
+        char separator = text_separator(opt);
+        const double *data = A->matrix[0];
+        size_t len = 0;
+        matrix_strides(A, &rs, &cs);
+        for (int y = 0; y < A->rows && ret == 0; y++) {
+            for (int x = 0; x < A->columns && ret == 0; x++) {
+                if (TEXT_BUFFER - len < TEXT_NUMBER + 2) {
+                    ret = fwrite(buf, 1, len, f) == len ? 0 : 2;
+                    len = 0;
+                }
+                len += text_format(buf + len, data[(size_t)y * rs + (size_t)x * cs], precision);
+                buf[len++] = x + 1 < A->columns ? separator : '\n';
+            }
+        }
+        if (ret == 0 && fwrite(buf, 1, len, f) != len)
+            ret = 2;
+        free(buf);
+    }
+
+    return ret;
+}
+
+/*
+ * Читает построчно не больше max_rows строк (0 - до конца файла), пустые строки пропускаются.
+ * Повторные вызовы продолжают с того же места, так что файл больше памяти читается блоками.
+ * 1 - строк не осталось, 2 - ошибка чтения, плохое число или разное число столбцов.
+ */
+int s21_read_matrix_text(FILE *f, const s21_text_options_t *opt, int max_rows, matrix_t *result) {
+    int ret = 0, rows = 0, columns = 0;
+    char *line = NULL;
+    size_t line_capacity = 0;
+    char separator = text_separator(opt);
+    text_values_t values = {NULL, 0, 0};
+    result->matrix = NULL;
+    result->rows = 0;
+    result->columns = 0;
+    result->flags = 0;
+
+    if (f == NULL || separator == 0 || max_rows < 0)
+        ret = 1;
+    while (ret == 0 && (max_rows == 0 || rows < max_rows) && getline(&line, &line_capacity, f) != -1) {
+        int n = text_parse_row(line, separator, &values);
+        if (n < 0 || (rows > 0 && n > 0 && n != columns)) {
+            ret = 2;
+        } else if (n > 0) {
+            columns = n;
+            rows++;
+        }
+    }
+
+    if (ret == 0 && ferror(f)) {
+        ret = 2;
+    } else if (ret == 0 && rows == 0) {
+        ret = 1;
+    } else if (ret == 0 && s21_create_matrix(rows, columns, result) != 0) {
+        ret = 2;
+    } else if (ret == 0) {
+        memcpy(result->matrix[0], values.data, values.count * sizeof(double));
+    }
+    free(values.data);
+    free(line);
+
+    return ret;
+}
+
+// 0 - неизвестный формат.
+static char text_separator(const s21_text_options_t *opt) {
+    char separator = 0;
+    int format = opt != NULL ? opt->format : S21_TEXT_SPACE;
+
+    if (format == S21_TEXT_SPACE)
+        separator = ' ';
+    else if (format == S21_TEXT_CSV)
+        separator = ',';
+    else if (format == S21_TEXT_TSV)
+        separator = '\t';
+
+    return separator;
+}
+
+static int text_format(char *out, double value, int precision) {
+    int len = 0;
+
+    if (precision > 0)
+        len = snprintf(out, TEXT_NUMBER, "%.*g", precision, value);
+    else
+        len = text_shortest(out, value);
+
+    return len;
+}
+
+/*
+ * 17 значащих цифр берутся из long double одним умножением на точную степень 10, из них
+ * округлением получаются 15 и 16. Кандидат принимается, только если text_parse_double
+ * возвращает то же число, так что неточность long double влияет лишь на длину записи.
+ * Остальное (ноль, inf, nan, порядки вне таблицы) перебирает snprintf с проверкой strtod.
+ */
+static int text_shortest(char *out, double value) {
+    int len = 0, found = 0;
+    double a = fabs(value);
+    int e10 = a > 0 && isfinite(a) ? (int)floor(log10(a)) : 0;
+    uint64_t m = 0;
+
+    // log10 у степеней 10 может ошибиться на единицу, тогда цифр 16 или 18.
+    for (int k = 16 - e10, tries = 0; a > 0 && isfinite(a) && k >= -27 && k <= 27 && tries < 2;
+         k = 16 - e10, tries++) {
+        long double scaled = k >= 0 ? (long double)a * text_pow10l[k] : (long double)a / text_pow10l[-k];
+        m = (uint64_t)llroundl(scaled);
+        if (m >= 100000000000000000ull)
+            e10++;
+        else if (m < 10000000000000000ull)
+            e10--;
+        else
+            tries = 2;
+    }
+
+    if (m >= 10000000000000000ull && m < 100000000000000000ull) {
+        for (int p = 15; p <= 17 && !found; p++) {
+            uint64_t div = p == 15 ? 100 : p == 16 ? 10 : 1;
+            uint64_t nearest = (m + div / 2) / div;
+            // Округление уже округлённых 17 цифр может уйти не в ту сторону, второй сосед тоже проверяется.
+            uint64_t other = nearest * div > m ? nearest - 1 : nearest + 1;
+            for (int c = 0; c < (p < 17 ? 2 : 1) && !found; c++) {
+                double back = 0;
+                len = text_render(out, value < 0, c ? other : nearest, e10 - p + 1);
+                found = *text_parse_double(out, &back) == '\0' && back == value;
+            }
+        }
+    }
+    for (int p = 15; p <= 17 && !found; p++) {
+        len = snprintf(out, TEXT_NUMBER, "%.*g", p, value);
+        found = p == 17 || strtod(out, NULL) == value;
+    }
+
+    return len;
+}
+
+// digits * 10^exponent как %g: без хвостовых нулей, экспонента при порядке вне [-4, 17).
+static int text_render(char *out, int negative, uint64_t digits, int exponent) {
+    char d[24];
+    int nd = 0, len = 0, e;
+
+    for (; digits % 10 == 0 && digits != 0; exponent++)
+        digits /= 10;
+    for (; digits != 0 || nd == 0; digits /= 10)
+        d[nd++] = (char)('0' + digits % 10);
+    e = exponent + nd - 1;
+    if (negative)
+        out[len++] = '-';
+
+    if (e < -4 || e >= 17) {
+        out[len++] = d[nd - 1];
+        if (nd > 1)
+            out[len++] = '.';
+        for (int i = nd - 2; i >= 0; i--)
+            out[len++] = d[i];
+        out[len++] = 'e';
+        out[len++] = e < 0 ? '-' : '+';
+        e = e < 0 ? -e : e;
+        if (e >= 100)
+            out[len++] = (char)('0' + e / 100);
+        out[len++] = (char)('0' + e / 10 % 10);
+        out[len++] = (char)('0' + e % 10);
+    } else if (e < 0) {
+        out[len++] = '0';
+        out[len++] = '.';
+        for (int i = -1; i > e; i--)
+            out[len++] = '0';
+        for (int i = nd - 1; i >= 0; i--)
+            out[len++] = d[i];
+    } else {
+        for (int i = nd - 1; i >= 0; i--) {
+            out[len++] = d[i];
+            if (i == nd - 1 - e && i > 0)
+                out[len++] = '.';
+        }
+        for (int i = nd - 1; i < e; i++)
+            out[len++] = '0';
+    }
+    out[len] = '\0';
+
+    return len;
+}
+
+// Дописывает числа строки в values; возвращает их количество или -1.
+static int text_parse_row(char *s, char separator, text_values_t *values) {
+    int n = 0;
+
+    while (n >= 0 && *s != '\0') {
+        double value = 0;
+        char *end;
+        while (text_is_blank(*s, separator))
+            s++;
+        end = *s != '\0' ? text_parse_double(s, &value) : s;
+        if (end == s && *s != '\0') {
+            n = -1;
+        } else if (end != s) {
+            if (values->count == values->capacity) {
+                size_t capacity = values->capacity ? values->capacity * 2 : 1024;
+                double *grown = (double *)realloc(values->data, capacity * sizeof(double));
+                if (grown == NULL) {
+                    n = -1;
+                } else {
+                    values->data = grown;
+                    values->capacity = capacity;
+                }
+            }
+            if (n >= 0) {
+                values->data[values->count++] = value;
+                n++;
+            }
+            s = end;
+            while (text_is_blank(*s, separator))
+                s++;
+            // Между числами - separator; для пробельного формата хватает уже пропущенных пробелов.
+            if (separator != ' ' && *s == separator)
+                s++;
+            else if (*s != '\0' && (separator != ' ' || s == end))
+                n = -1;
+        }
+    }
+
+    return n;
+}
+
+/*
+ * Мантисса до 2^53 и степень 10 до 22 представимы точно, поэтому их произведение или частное
+ * округляется один раз и совпадает с strtod. Остальное (длинные мантиссы, большие порядки,
+ * inf и nan) разбирает strtod.
+ */
+static char *text_parse_double(char *s, double *value) {
+    char *p = s;
+    uint64_t mantissa = 0;
+    int negative = 0, digits = 0, any = 0, exact = 1, exponent = 0;
+
+    if (*p == '-' || *p == '+')
+        negative = *p++ == '-';
+    for (; *p >= '0' && *p <= '9'; p++, any = 1) {
+        if (digits < TEXT_DIGITS) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits += mantissa != 0;
+        } else {
+            exact = 0;
+        }
+    }
+    if (*p == '.') {
+        for (p++; *p >= '0' && *p <= '9'; p++, any = 1) {
+            if (digits < TEXT_DIGITS) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits += mantissa != 0;
+                exponent--;
+            } else {
+                exact = 0;
+            }
+        }
+    }
+    if (any && (*p == 'e' || *p == 'E')) {
+        char *q = p + 1;
+        int sign = 1, e = 0;
+        if (*q == '-' || *q == '+')
+            sign = *q++ == '-' ? -1 : 1;
+        if (*q >= '0' && *q <= '9') {
+            for (; *q >= '0' && *q <= '9'; q++)
+                e = e < 10000 ? e * 10 + (*q - '0') : e;
+            exponent += sign * e;
+            p = q;
+        }
+    }
+
+    if (!any || !exact || mantissa > TEXT_EXACT || exponent < -22 || exponent > 22) {
+        *value = strtod(s, &p);
+    } else {
+        *value = exponent < 0 ? (double)mantissa / text_pow10[-exponent]
+                              : (double)mantissa * text_pow10[exponent];
+        if (negative)
+            *value = -*value;
+    }
+
+    return p;
+}
+
+static int text_is_blank(char c, char separator) {
+    return c == ' ' || c == '\r' || c == '\n' || (c == '\t' && separator != '\t');
+}
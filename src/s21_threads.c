@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <unistd.h>
+#include "s21_matrix.h"
+
+// Постоянный пул потоков: создаётся при первом параллельном вызове и переиспользуется.
+typedef struct thread_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+    pthread_t       *workers;
+    int             count;
+    int             requested;
+    int             stop;
+    int             busy;
+    int             hooks;
+    unsigned long   generation;
+    task_fn         fn;
+    void            *arg;
+    int             tasks;
+    int             next;
+    int             finished;
+    int             ret;
+    int             target;
+} thread_pool_t;
+
+static thread_pool_t pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                             PTHREAD_COND_INITIALIZER, NULL, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0, 0, 0, 0};
+static _Thread_local int in_pool = 0;
+
+static void *worker_main(void *unused);
+static void run_tasks_locked(void);
+static void pool_resize_locked(int count);
+static void pool_at_exit(void);
+static void pool_after_fork(void);
+
+int s21_set_num_threads(int count) {
+    int ret = 0;
+
+    if (count < 0) {
+        ret = 1;
+    } else {
+        pthread_mutex_lock(&pool.lock);
+        pool.requested = count;
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    return ret;
+}
+
+int s21_get_num_threads(void) {
+    pthread_mutex_lock(&pool.lock);
+    int count = pool.requested;
+    pthread_mutex_unlock(&pool.lock);
+
+    if (count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        count = cpus > 0 ? (int)cpus : 1;
+    }
+
+    return count;
+}
+
+int parallel_for(int tasks, task_fn fn, void *arg) {
+    int ret = 0;
+    int threads = s21_get_num_threads();
+    int serial = tasks <= 1 || threads <= 1 || in_pool;
+
+    if (!serial) {
+        pthread_mutex_lock(&pool.lock);
+        // Пул уже занят другим вызывающим потоком - считаем сами, без ожидания.
+        serial = pool.busy;
+        if (!serial) {
+            pool.busy = 1;
+            // target - последний запрошенный размер: если часть потоков не создалась,
+            // пул работает с теми, что есть, и не пересоздаётся при каждом вызове.
+            if (pool.target != threads - 1)
+                pool_resize_locked(threads - 1);
+            pool.fn = fn;
+            pool.arg = arg;
+            pool.tasks = tasks;
+            pool.next = 0;
+            pool.finished = 0;
+            pool.ret = 0;
+            pool.generation++;
+            pthread_cond_broadcast(&pool.wake);
+
+            in_pool = 1;
+            run_tasks_locked();
+            in_pool = 0;
+            while (pool.finished < pool.tasks)
+                pthread_cond_wait(&pool.done, &pool.lock);
+            ret = pool.ret;
+            pool.fn = NULL;
+            pool.busy = 0;
+        }
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    if (serial) {
+        for (int t = 0; t < tasks; t++) {
+            int r = fn(arg, t);
+            if (r > ret)
+                ret = r;
+        }
+    }
+
+    return ret;
+}
+
+static void *worker_main(void *unused) {
+    (void)unused;
+    in_pool = 1;
+    pthread_mutex_lock(&pool.lock);
+    // Поток, созданный во время уже начатого вызова, сразу подключается к нему.
+    unsigned long seen = pool.fn != NULL ? pool.generation - 1 : pool.generation;
+
+    while (!pool.stop) {
+        if (pool.generation == seen) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        } else {
+            seen = pool.generation;
+            run_tasks_locked();
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    return NULL;
+}
+
+// Вызывается под pool.lock, сама задача выполняется без блокировки.
+static void run_tasks_locked(void) {
+    while (pool.fn != NULL && pool.next < pool.tasks) {
+        int t = pool.next++;
+        task_fn fn = pool.fn;
+        void *arg = pool.arg;
+
+        pthread_mutex_unlock(&pool.lock);
+        int r = fn(arg, t);
+        pthread_mutex_lock(&pool.lock);
+
+        if (r > pool.ret)
+            pool.ret = r;
+        if (++pool.finished == pool.tasks)
+            pthread_cond_broadcast(&pool.done);
+    }
+}
+
+// Вызывается под pool.lock владельцем пула (busy), поэтому задач в работе нет.
+static void pool_resize_locked(int count) {
+    if (!pool.hooks) {
+        pool.hooks = 1;
+        atexit(pool_at_exit);
+        pthread_atfork(NULL, NULL, pool_after_fork);
+    }
+
+    if (pool.count > 0) {
+        pthread_t *workers = pool.workers;
+        int old = pool.count;
+        pool.stop = 1;
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+        for (int i = 0; i < old; i++)
+            pthread_join(workers[i], NULL);
+        pthread_mutex_lock(&pool.lock);
+        free(workers);
+        pool.workers = NULL;
+        pool.count = 0;
+        pool.stop = 0;
+    }
+
+    pool.target = count;
+    pool.workers = count > 0 ? (pthread_t *)malloc(sizeof(pthread_t) * count) : NULL;
+    for (int i = 0; pool.workers != NULL && i < count && pool.count == i; i++)
+        if (pthread_create(&pool.workers[i], NULL, worker_main, NULL) == 0)
+            pool.count++;
+}
+
+static void pool_at_exit(void) {
+    pthread_mutex_lock(&pool.lock);
+    if (!pool.busy)
+        pool_resize_locked(0);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+// В дочернем процессе после fork рабочих потоков нет, пул создаётся заново.
+static void pool_after_fork(void) {
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.count = 0;
+    pool.target = 0;
+    pool.stop = 0;
+    pool.busy = 0;
+    pool.fn = NULL;
+    in_pool = 0;
+}
@@ -0,0 +1,86 @@
+#include "s21_matrix.h"
+
+// Сторона тайла: исходный и целевой тайлы вместе помещаются в L1.
+#ifndef TRANSPOSE_BLOCK
+#define TRANSPOSE_BLOCK 32
+#endif
+
+static void transpose_square(double **a, int n);
+static void transpose_cycles(double *a, int rows, int columns, unsigned char *seen);
+
+// dst = src^T, src - rows x columns, обход по тайлам TRANSPOSE_BLOCK x TRANSPOSE_BLOCK.
+void transpose_blocked(const double *src, int rows, int columns, double *dst) {
+    for (int yb = 0; yb < rows; yb += TRANSPOSE_BLOCK) {
+        int h = rows - yb < TRANSPOSE_BLOCK ? rows - yb : TRANSPOSE_BLOCK;
+        for (int xb = 0; xb < columns; xb += TRANSPOSE_BLOCK) {
+            int w = columns - xb < TRANSPOSE_BLOCK ? columns - xb : TRANSPOSE_BLOCK;
+            vec_transpose(dst + (size_t)xb * rows + yb, rows, src + (size_t)yb * columns + xb, columns, h, w);
+        }
+    }
+}
+
+int s21_transpose_inplace(matrix_t *A) {
+    STATS_BEGIN();
+    int ret = 0;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else if (matrix_is_transposed(A) || (A->flags & S21_BORROWED)) {
+        // Транспонированное хранилище уже лежит в нужном порядке, достаточно снять флаг;
+        // чужое хранилище (S21_BORROWED) не переставляется, меняется только ориентация.
+        int rows = A->rows;
+        A->rows = A->columns;
+        A->columns = rows;
+        A->flags ^= S21_TRANSPOSED;
+    } else if (A->rows == A->columns) {
+        transpose_square(A->matrix, A->rows);
+    } else {
+        int rows = A->rows, columns = A->columns;
+        unsigned char *seen = (unsigned char *)calloc(((size_t)rows * columns) / 8 + 1, 1);
+        // Сначала форма: если массив строк не помещается в блок, матрица остаётся нетронутой.
+        if (seen == NULL || matrix_reshape(A, columns, rows) != 0)
+            ret = 2;
+        else
+            transpose_cycles(A->matrix[0], rows, columns, seen);
+        free(seen);
+    }
+
+    STATS_END(transpose_inplace, 0);
+    return ret;
+}
+
+// Обмен симметричных тайлов относительно диагонали.
+static void transpose_square(double **a, int n) {
+    for (int yb = 0; yb < n; yb += TRANSPOSE_BLOCK) {
+        int ye = yb + TRANSPOSE_BLOCK < n ? yb + TRANSPOSE_BLOCK : n;
+        for (int xb = yb; xb < n; xb += TRANSPOSE_BLOCK) {
+            int xe = xb + TRANSPOSE_BLOCK < n ? xb + TRANSPOSE_BLOCK : n;
+            for (int y = yb; y < ye; y++)
+                for (int x = xb == yb ? y + 1 : xb; x < xe; x++) {
+                    double t = a[y][x];
+                    a[y][x] = a[x][y];
+                    a[x][y] = t;
+                }
+        }
+    }
+}
+
+// Элемент с индексом i переходит в i * rows mod (N - 1); каждый цикл обходится один раз,
+// пройденные позиции отмечаются в битовой карте (N / 8 байт вместо второй копии).
+static void transpose_cycles(double *a, int rows, int columns, unsigned char *seen) {
+    size_t last = (size_t)rows * columns - 1;
+
+    for (size_t start = 1; start < last; start++) {
+        if (seen[start / 8] & (1u << (start % 8)))
+            continue;
+        double carry = a[start];
+        size_t i = start;
+        do {
+            i = i * rows % last;
+            double t = a[i];
+            a[i] = carry;
+            carry = t;
+            seen[i / 8] |= (unsigned char)(1u << (i % 8));
+        } while (i != start);
+    }
+}
@@ -0,0 +1,124 @@
+#include "s21_matrix.h"
+
+// result делит память с A и не владеет ею: меняются только размеры и флаг ориентации.
+// При result == A матрица просто помечается транспонированной и остаётся владельцем памяти.
+int s21_transpose_lazy(matrix_t *A, matrix_t *result) {
+    int ret = 0;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else {
+        int rows = A->rows;
+        int flags = result == A ? A->flags : A->flags | S21_BORROWED;
+        result->matrix = A->matrix;
+        result->rows = A->columns;
+        result->columns = rows;
+        result->flags = flags ^ S21_TRANSPOSED;
+    }
+
+    return ret;
+}
+
+int s21_matrix_view(matrix_t *A, matrix_view_t *view) {
+    int ret = 1;
+
+    if (!matrix_is_empty(A))
+        ret = s21_submatrix_view(A, 0, 0, A->rows, A->columns, view);
+
+    return ret;
+}
+
+int s21_submatrix_view(matrix_t *A, int row, int column, int rows, int columns, matrix_view_t *view) {
+    int ret = 0;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else if (row < 0 || column < 0 || rows < 1 || columns < 1 ||
+               rows > A->rows - row || columns > A->columns - column) {
+        ret = 2;
+    } else {
+        matrix_strides(A, &view->row_stride, &view->column_stride);
+        view->base = A->matrix[0] + (size_t)row * view->row_stride + (size_t)column * view->column_stride;
+        view->rows = rows;
+        view->columns = columns;
+        view->skip_row = INT_MAX;
+        view->skip_column = INT_MAX;
+    }
+
+    return ret;
+}
+
+int s21_minor_view(matrix_t *A, int oy, int ox, matrix_view_t *view) {
+    int ret = 0;
+
+    if (matrix_is_empty(A)) {
+        ret = 1;
+    } else if (A->rows < 2 || A->columns < 2 || oy < 0 || ox < 0 || oy >= A->rows || ox >= A->columns) {
+        ret = 2;
+    } else {
+        s21_matrix_view(A, view);
+        view->rows--;
+        view->columns--;
+        view->skip_row = oy;
+        view->skip_column = ox;
+    }
+
+    return ret;
+}
+
+int s21_view_to_matrix(const matrix_view_t *view, matrix_t *result) {
+    int ret = s21_create_matrix(view->rows, view->columns, result);
+
+    if (ret == 0)
+        view_to_buffer(view, result->matrix[0]);
+
+    return ret;
+}
+
+// Копирование построчно: подряд идущие участки строки - через memcpy.
+void view_to_buffer(const matrix_view_t *view, double *buf) {
+    for (int y = 0; y < view->rows; y++, buf += view->columns) {
+        const double *src = view->base + (size_t)(y + (y >= view->skip_row)) * view->row_stride;
+        if (view->column_stride == 1) {
+            int head = view->skip_column < view->columns ? view->skip_column : view->columns;
+            memcpy(buf, src, sizeof(double) * head);
+            if (head < view->columns)
+                memcpy(buf + head, src + head + 1, sizeof(double) * (view->columns - head));
+        } else {
+            for (int x = 0; x < view->columns; x++)
+                buf[x] = src[(size_t)(x + (x >= view->skip_column)) * view->column_stride];
+        }
+    }
+}
+
+int s21_view_determinant(const matrix_view_t *view, double *result) {
+    int ret = 0;
+    int n = view->rows;
+
+    if (n != view->columns) {
+        ret = 2;
+    } else if (n == 1) {
+        *result = view_at(view, 0, 0);
+    } else if (n == 2) {
+        *result = view_at(view, 0, 0) * view_at(view, 1, 1) - view_at(view, 1, 0) * view_at(view, 0, 1);
+    } else if (n == 3) {
+        *result = view_at(view, 0, 0) * (view_at(view, 1, 1) * view_at(view, 2, 2) -
+                                         view_at(view, 1, 2) * view_at(view, 2, 1))
+                - view_at(view, 0, 1) * (view_at(view, 1, 0) * view_at(view, 2, 2) -
+                                         view_at(view, 1, 2) * view_at(view, 2, 0))
+                + view_at(view, 0, 2) * (view_at(view, 1, 0) * view_at(view, 2, 1) -
+                                         view_at(view, 1, 1) * view_at(view, 2, 0));
+    } else {
+        // LU-разложение с частичным выбором ведущего элемента в одном буфере, O(n^3).
+        double *buf = scratch_alloc((size_t)n * n);
+        if (buf == NULL) {
+            ret = 2;
+        } else {
+            view_to_buffer(view, buf);
+            *result = lu_determinant(buf, n);
+            scratch_free(buf);
+        }
+    }
+
+    return ret;
+}
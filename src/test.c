@@ -1,10 +1,14 @@
 #include "s21_matrix.h"
+#include <float.h>
 #include <check.h>
 
 #define SUCCESS 1
 #define FAILURE 0
 
 void fill(matrix_t *m, double c);
+void fill_random(matrix_t *m, unsigned seed);
+double ref_determinant(matrix_t *A);
+void ref_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result);
 
 START_TEST(create_matrix) {
     int result;
@@ -28,6 +32,75 @@ START_TEST(create_matrix) {
 }
 END_TEST
 
+START_TEST(create_matrix_contiguous) {
+    matrix_t M;
+
+    ck_assert_int_eq(s21_create_matrix(5, 7, &M), 0);
+    ck_assert_int_eq((uintptr_t)M.matrix[0] % MATRIX_ALIGN, 0);
+    for (int y = 0; y < 5; y++) {
+        ck_assert_ptr_eq(M.matrix[y], M.matrix[0] + y * 7);
+        for (int x = 0; x < 7; x++)
+            ck_assert_double_eq(M.matrix[y][x], 0);
+    }
+    s21_remove_matrix(&M);
+    ck_assert_ptr_null(M.matrix);
+
+    ck_assert_int_eq(s21_create_matrix(1 << 30, 1 << 30, &M), 2);
+    ck_assert_ptr_null(M.matrix);
+}
+END_TEST
+
+START_TEST(arena_matrices) {
+    s21_arena_t *arena = s21_arena_create(4096);
+    matrix_t a, b, c;
+
+    ck_assert_ptr_nonnull(arena);
+    ck_assert_int_eq(s21_create_matrix_in(arena, 0, 3, &a), 1);
+    ck_assert_int_eq(s21_create_matrix_in(NULL, 3, 3, &a), 2);
+    ck_assert_int_eq(s21_create_matrix_in(arena, 4, 4, &a), 0);
+    ck_assert_int_eq(s21_create_matrix_in(arena, 4, 4, &b), 0);
+    ck_assert_int_eq((uintptr_t)a.matrix[0] % MATRIX_ALIGN, 0);
+    fill(&a, 1);
+    fill(&b, 2);
+    ck_assert_int_eq(s21_sum_matrix_inplace(&a, &b), 0);
+    ck_assert_double_eq(a.matrix[3][3], 16 + 31);
+
+    // Больше ёмкости одного куска - арена добавляет новый.
+    ck_assert_int_eq(s21_create_matrix_in(arena, 40, 40, &c), 0);
+    ck_assert_double_eq(c.matrix[39][39], 0);
+    s21_remove_matrix(&c);
+    ck_assert_ptr_null(c.matrix);
+
+    double *first = a.matrix[0];
+    s21_arena_reset(arena);
+    ck_assert_int_eq(s21_create_matrix_in(arena, 4, 4, &a), 0);
+    ck_assert_ptr_eq(a.matrix[0], first);
+    ck_assert_double_eq(a.matrix[3][3], 0);
+    s21_arena_destroy(arena);
+}
+END_TEST
+
+START_TEST(pool_matrices) {
+    s21_pool_t *pool = s21_pool_create();
+    matrix_t a, b;
+
+    ck_assert_int_eq(s21_create_matrix_pooled(pool, 3, 3, &a), 0);
+    double *first = a.matrix[0];
+    a.matrix[2][2] = 5;
+    s21_remove_matrix(&a);
+    ck_assert_int_eq(s21_create_matrix_pooled(pool, 3, 3, &a), 0);
+    ck_assert_ptr_eq(a.matrix[0], first);
+    ck_assert_double_eq(a.matrix[2][2], 0);
+    ck_assert_int_eq(s21_create_matrix_pooled(pool, 3, -3, &b), 1);
+
+    // Пул, уничтоженный при живой матрице, освобождается вместе с ней.
+    s21_pool_destroy(pool);
+    ck_assert_int_eq(s21_create_matrix_pooled(NULL, 3, 3, &b), 2);
+    a.matrix[1][1] = 1;
+    s21_remove_matrix(&a);
+}
+END_TEST
+
 START_TEST(remove_matrix) {
     matrix_t M;
 
@@ -331,12 +404,12 @@ START_TEST(inverse_matrix) {
     double inversed[9] = {1, -1, 1, -38, 41, -34, 27, -29, 24};
     for (int y = 0, n = 0; y < 3; y++)
         for (int x = 0; x < 3; x++, n++)
-            ck_assert_double_eq(Z.matrix[y][x], inversed[n]);
+            ck_assert_double_eq_tol(Z.matrix[y][x], inversed[n], 1e-6);
 
     s21_mult_matrix(&Y, &Z, &R);
     print_matrix(R);
     for (int i = 0; i < 3; i++)
-        ck_assert_double_eq(R.matrix[i][i], 1.0);
+        ck_assert_double_eq_tol(R.matrix[i][i], 1.0, 1e-6);
 
     s21_remove_matrix(&Y);
     s21_remove_matrix(&Z);
@@ -783,6 +856,196 @@ START_TEST(mult_matrix_7) {
 }
 END_TEST
 
+START_TEST(mult_matrix_blocked) {
+  // Размеры выбраны так, чтобы задеть хвосты тайлов и несколько панелей KC.
+  int shapes[][3] = {{1, 1, 1}, {2, 3, 4}, {37, 53, 29}, {5, 300, 7}, {130, 270, 101}};
+
+  for (int i = 0; i < 5; i++) {
+    matrix_t a, b, c, r;
+    s21_create_matrix(shapes[i][0], shapes[i][1], &a);
+    s21_create_matrix(shapes[i][1], shapes[i][2], &b);
+    fill_random(&a, i + 1);
+    fill_random(&b, i + 100);
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &c), 0);
+    ck_assert_int_eq(c.rows, shapes[i][0]);
+    ck_assert_int_eq(c.columns, shapes[i][2]);
+    ref_mult_matrix(&a, &b, &r);
+    double tol = EPS * shapes[i][1] * 100;
+    for (int y = 0; y < c.rows; y++)
+      for (int x = 0; x < c.columns; x++)
+        ck_assert_double_eq_tol(c.matrix[y][x], r.matrix[y][x], tol);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&c);
+    s21_remove_matrix(&r);
+  }
+}
+END_TEST
+
+START_TEST(mult_matrix_threads) {
+  matrix_t a, b, c, r;
+  s21_create_matrix(250, 170, &a);
+  s21_create_matrix(170, 310, &b);
+  fill_random(&a, 7);
+  fill_random(&b, 8);
+  ref_mult_matrix(&a, &b, &r);
+
+  ck_assert_int_eq(s21_set_num_threads(-1), 1);
+  for (int threads = 1; threads <= 5; threads += 2) {
+    ck_assert_int_eq(s21_set_num_threads(threads), 0);
+    ck_assert_int_eq(s21_get_num_threads(), threads);
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &c), 0);
+    for (int y = 0; y < c.rows; y++)
+      for (int x = 0; x < c.columns; x++)
+        ck_assert_double_eq_tol(c.matrix[y][x], r.matrix[y][x], 1e-6);
+    s21_remove_matrix(&c);
+  }
+  s21_set_num_threads(0);
+  ck_assert_int_ge(s21_get_num_threads(), 1);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&r);
+}
+END_TEST
+START_TEST(mult_matrix_strassen) {
+  // Маленький порог, чтобы рекурсия прошла несколько уровней с нечётными и прямоугольными сторонами.
+  int shapes[][3] = {{64, 64, 64}, {65, 71, 67}, {100, 37, 90}, {129, 127, 131}};
+  ck_assert_int_eq(s21_set_mult_policy(S21_MULT_STRASSEN, 8), 0);
+  ck_assert_int_eq(s21_get_mult_policy(), S21_MULT_STRASSEN);
+
+  for (int i = 0; i < 4; i++) {
+    matrix_t a, b, t, bt, c, r;
+    s21_create_matrix(shapes[i][0], shapes[i][1], &a);
+    s21_create_matrix(shapes[i][2], shapes[i][1], &b);
+    fill_random(&a, i + 1);
+    fill_random(&b, i + 100);
+    s21_transpose_lazy(&b, &t);
+    ck_assert_int_eq(s21_mult_matrix(&a, &t, &c), 0);
+    ck_assert_int_eq(c.columns, shapes[i][2]);
+    s21_transpose(&b, &bt);
+    ref_mult_matrix(&a, &bt, &r);
+    for (int y = 0; y < c.rows; y++)
+      for (int x = 0; x < c.columns; x++)
+        ck_assert_double_eq_tol(c.matrix[y][x], r.matrix[y][x], 1e-9);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&t);
+    s21_remove_matrix(&bt);
+    s21_remove_matrix(&c);
+    s21_remove_matrix(&r);
+  }
+  ck_assert_int_eq(s21_set_mult_policy(7, 0), 1);
+  ck_assert_int_eq(s21_set_mult_policy(S21_MULT_STRASSEN, -1), 1);
+  ck_assert_int_eq(s21_set_mult_policy(S21_MULT_CLASSIC, 0), 0);
+}
+END_TEST
+
+START_TEST(simd_dispatch_levels) {
+  // Принудительно проходим все уровни, которые поддерживает процессор.
+  ck_assert_int_eq(s21_set_simd_level(S21_SIMD_AVX512 + 1), 1);
+  for (int level = S21_SIMD_SCALAR; level <= s21_simd_supported(); level++) {
+    ck_assert_int_eq(s21_set_simd_level(level), 0);
+    ck_assert_int_eq(s21_get_simd_level(), level);
+    for (int size = 1; size <= 19; size += 3) {
+      matrix_t a, b, sum, sub, mul;
+      s21_create_matrix(size, 3, &a);
+      s21_create_matrix(size, 3, &b);
+      fill_random(&a, size);
+      fill_random(&b, size + 1);
+      ck_assert_int_eq(s21_sum_matrix(&a, &b, &sum), 0);
+      ck_assert_int_eq(s21_sub_matrix(&a, &b, &sub), 0);
+      ck_assert_int_eq(s21_mult_number(&a, -1.5, &mul), 0);
+      for (int y = 0; y < size; y++)
+        for (int x = 0; x < 3; x++) {
+          ck_assert_double_eq(sum.matrix[y][x], a.matrix[y][x] + b.matrix[y][x]);
+          ck_assert_double_eq(sub.matrix[y][x], a.matrix[y][x] - b.matrix[y][x]);
+          ck_assert_double_eq(mul.matrix[y][x], a.matrix[y][x] * -1.5);
+        }
+      ck_assert_int_eq(s21_axpy(2, &a, &mul), 0);
+      for (int y = 0; y < size; y++)
+        for (int x = 0; x < 3; x++)
+          ck_assert_double_eq_tol(mul.matrix[y][x], a.matrix[y][x] * 0.5, 1e-12);
+      for (int i = 0; i < size * 3; i++) {
+        b.matrix[0][i] = a.matrix[0][i] + EPS / 2;
+      }
+      ck_assert_int_eq(s21_eq_matrix(&a, &b), SUCCESS);
+      for (int i = 0; i < size * 3; i++) {
+        b.matrix[0][i] = a.matrix[0][i] - EPS * 2;
+        ck_assert_int_eq(s21_eq_matrix(&a, &b), FAILURE);
+        b.matrix[0][i] = a.matrix[0][i];
+      }
+      s21_remove_matrix(&a);
+      s21_remove_matrix(&b);
+      s21_remove_matrix(&sum);
+      s21_remove_matrix(&sub);
+      s21_remove_matrix(&mul);
+    }
+  }
+  ck_assert_int_eq(s21_set_simd_level(-1), 0);
+  ck_assert_int_eq(s21_get_simd_level(), s21_simd_supported());
+}
+END_TEST
+
+START_TEST(inplace_arithmetic) {
+  matrix_t a, b, c, empty = {NULL, 0, 0, 0};
+  s21_create_matrix(4, 5, &a);
+  s21_create_matrix(4, 5, &b);
+  s21_create_matrix(5, 4, &c);
+  fill(&a, 1);
+  fill(&b, 0.5);
+
+  ck_assert_int_eq(s21_sum_matrix_inplace(&a, &b), 0);
+  ck_assert_double_eq(a.matrix[3][4], 20 + 10.5);
+  ck_assert_int_eq(s21_sub_matrix_inplace(&a, &b), 0);
+  ck_assert_double_eq(a.matrix[3][4], 20);
+  ck_assert_int_eq(s21_mult_number_inplace(&a, 2), 0);
+  ck_assert_double_eq(a.matrix[1][2], 16);
+  ck_assert_int_eq(s21_axpy(-2, &b, &a), 0);
+  ck_assert_double_eq_tol(a.matrix[1][2], 16 - 2 * 4.5, 1e-12);
+
+  ck_assert_int_eq(s21_sum_matrix_inplace(&a, &c), 2);
+  ck_assert_int_eq(s21_sub_matrix_inplace(&empty, &b), 1);
+  ck_assert_int_eq(s21_axpy(1, &a, &c), 2);
+  ck_assert_int_eq(s21_mult_number_inplace(&empty, 2), 1);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&c);
+}
+END_TEST
+
+START_TEST(gemm_alpha_beta) {
+  matrix_t a, b, c, r;
+  s21_create_matrix(33, 21, &a);
+  s21_create_matrix(21, 17, &b);
+  s21_create_matrix(33, 17, &c);
+  fill_random(&a, 3);
+  fill_random(&b, 4);
+  fill_random(&c, 5);
+  ref_mult_matrix(&a, &b, &r);
+
+  double old = c.matrix[7][9];
+  ck_assert_int_eq(s21_gemm(0.5, &a, &b, -2, &c), 0);
+  ck_assert_double_eq_tol(c.matrix[7][9], 0.5 * r.matrix[7][9] - 2 * old, 1e-9);
+
+  c.matrix[0][0] = NAN;
+  ck_assert_int_eq(s21_gemm(1, &a, &b, 0, &c), 0);
+  for (int y = 0; y < 33; y++)
+    for (int x = 0; x < 17; x++)
+      ck_assert_double_eq_tol(c.matrix[y][x], r.matrix[y][x], 1e-9);
+
+  ck_assert_int_eq(s21_gemm(1, &a, &b, 1, &a), 2);
+  ck_assert_int_eq(s21_gemm(1, &b, &a, 1, &c), 2);
+  s21_remove_matrix(&c);
+  ck_assert_int_eq(s21_gemm(1, &a, &b, 1, &c), 1);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&r);
+}
+END_TEST
+
 START_TEST(transpose_1) {
   matrix_t m, n, k;
   s21_create_matrix(3, 2, &m);
@@ -935,6 +1198,118 @@ START_TEST(determinant_6) {
 }
 END_TEST
 
+START_TEST(determinant_lu_regression) {
+  // Сравнение с разложением по первой строке для n <= 8.
+  for (int size = 1; size <= 8; size++) {
+    matrix_t m;
+    double d;
+    s21_create_matrix(size, size, &m);
+    fill_random(&m, size);
+    double expected = ref_determinant(&m);
+    ck_assert_int_eq(s21_determinant(&m, &d), 0);
+    ck_assert_double_eq_tol(d, expected, 1e-9 * (1 + fabs(expected)));
+    s21_remove_matrix(&m);
+  }
+}
+END_TEST
+
+START_TEST(determinant_lu_singular) {
+  matrix_t m;
+  double d = 1;
+  s21_create_matrix(6, 6, &m);
+  fill_random(&m, 6);
+  for (int x = 0; x < 6; x++)
+    m.matrix[4][x] = 0;
+  ck_assert_int_eq(s21_determinant(&m, &d), 0);
+  ck_assert_double_eq(d, 0);
+  s21_remove_matrix(&m);
+}
+END_TEST
+
+START_TEST(determinant_lu_large) {
+  // Время замеряет make bench (--ops determinant); здесь только значение.
+  matrix_t m, t;
+  double d, dt;
+  s21_create_matrix(200, 200, &m);
+  fill_random(&m, 200);
+  for (int y = 0; y < 200; y++) {
+    for (int x = 0; x < 200; x++)
+      m.matrix[y][x] /= 1000.0;
+    m.matrix[y][y] += 1;
+  }
+  ck_assert_int_eq(s21_determinant(&m, &d), 0);
+  ck_assert(isfinite(d));
+  ck_assert_double_ne(d, 0);
+  s21_transpose(&m, &t);
+  ck_assert_int_eq(s21_determinant(&t, &dt), 0);
+  ck_assert_double_eq_tol(dt, d, 1e-9 * fabs(d));
+  s21_remove_matrix(&t);
+  s21_remove_matrix(&m);
+}
+END_TEST
+
+START_TEST(submatrix_view) {
+  matrix_t m, c;
+  matrix_view_t v;
+  s21_create_matrix(5, 6, &m);
+  fill(&m, 1);
+
+  ck_assert_int_eq(s21_submatrix_view(&m, 1, 2, 3, 4, &v), 0);
+  ck_assert_ptr_eq(v.base, &m.matrix[1][2]);
+  for (int y = 0; y < 3; y++)
+    for (int x = 0; x < 4; x++)
+      ck_assert_double_eq(view_at(&v, y, x), m.matrix[y + 1][x + 2]);
+  m.matrix[2][3] = -7;
+  ck_assert_double_eq(view_at(&v, 1, 1), -7);
+
+  ck_assert_int_eq(s21_view_to_matrix(&v, &c), 0);
+  ck_assert_int_eq(c.rows, 3);
+  ck_assert_int_eq(c.columns, 4);
+  ck_assert_double_eq(c.matrix[2][3], m.matrix[3][5]);
+  s21_remove_matrix(&c);
+
+  ck_assert_int_eq(s21_submatrix_view(&m, 3, 0, 3, 1, &v), 2);
+  ck_assert_int_eq(s21_submatrix_view(&m, 0, -1, 1, 1, &v), 2);
+  ck_assert_int_eq(s21_submatrix_view(&m, 0, 0, 0, 1, &v), 2);
+  s21_remove_matrix(&m);
+  ck_assert_int_eq(s21_submatrix_view(&m, 0, 0, 1, 1, &v), 1);
+}
+END_TEST
+
+START_TEST(minor_view) {
+  matrix_t m, g, c;
+  matrix_view_t v;
+  s21_create_matrix(5, 5, &m);
+  fill_random(&m, 11);
+
+  for (int oy = 0; oy < 5; oy++)
+    for (int ox = 0; ox < 5; ox++) {
+      double d1, d2;
+      ck_assert_int_eq(s21_minor_view(&m, oy, ox, &v), 0);
+      get_minor(&m, &g, oy, ox);
+      s21_view_to_matrix(&v, &c);
+      ck_assert_int_eq(s21_eq_matrix(&g, &c), SUCCESS);
+      s21_view_determinant(&v, &d1);
+      s21_determinant(&g, &d2);
+      ck_assert_double_eq_tol(d1, d2, 1e-9);
+      s21_remove_matrix(&g);
+      s21_remove_matrix(&c);
+    }
+
+  ck_assert_int_eq(s21_minor_view(&m, 5, 0, &v), 2);
+  s21_submatrix_view(&m, 0, 0, 2, 3, &v);
+  double d;
+  ck_assert_int_eq(s21_view_determinant(&v, &d), 2);
+  s21_remove_matrix(&m);
+
+  s21_create_matrix(1, 1, &m);
+  ck_assert_int_eq(s21_minor_view(&m, 0, 0, &v), 2);
+  get_minor(&m, &g, 0, 0);
+  ck_assert_ptr_null(g.matrix);
+  s21_remove_matrix(&m);
+}
+END_TEST
+
 START_TEST(calc_complements_1) {
   matrix_t m, n;
   s21_create_matrix(3, 3, &m);
@@ -1008,6 +1383,77 @@ START_TEST(calc_complements_4) {
 }
 END_TEST
 
+START_TEST(calc_complements_5) {
+  // Дополнение 1 x 1 - определитель пустого минора, т. е. 1 независимо от элемента.
+  matrix_t m, n;
+  s21_create_matrix(1, 1, &m);
+  m.matrix[0][0] = -7;
+  ck_assert_int_eq(s21_calc_complements(&m, &n), 0);
+  ck_assert_double_eq(n.matrix[0][0], 1);
+  s21_remove_matrix(&n);
+  m.matrix[0][0] = 0;
+  ck_assert_int_eq(s21_calc_complements(&m, &n), 0);
+  ck_assert_double_eq(n.matrix[0][0], 1);
+  s21_remove_matrix(&n);
+  s21_remove_matrix(&m);
+}
+END_TEST
+
+START_TEST(calc_complements_lu) {
+  // Невырожденные, ранга n-1 и ранга n-2 матрицы против разложения по минорам.
+  for (int size = 4; size <= 7; size++)
+    for (int kind = 0; kind < 3; kind++) {
+      matrix_t m, c;
+      s21_create_matrix(size, size, &m);
+      fill_random(&m, size * 3 + kind);
+      for (int x = 0; x < size && kind > 0; x++)
+        m.matrix[1][x] = 2 * m.matrix[0][x] - m.matrix[size - 1][x];
+      for (int x = 0; x < size && kind > 1; x++)
+        m.matrix[2][x] = m.matrix[0][x] + m.matrix[3][x];
+
+      ck_assert_int_eq(s21_calc_complements(&m, &c), 0);
+      for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++) {
+          matrix_t minor;
+          get_minor(&m, &minor, y, x);
+          double expected = ((y + x) % 2 ? -1 : 1) * ref_determinant(&minor);
+          ck_assert_double_eq_tol(c.matrix[y][x], expected, 1e-7 * (1 + fabs(expected)));
+          s21_remove_matrix(&minor);
+        }
+      s21_remove_matrix(&m);
+      s21_remove_matrix(&c);
+    }
+}
+END_TEST
+
+START_TEST(calc_complements_lu_large) {
+  matrix_t m, c;
+  s21_create_matrix(100, 100, &m);
+  fill_random(&m, 100);
+  for (int y = 0; y < 100; y++) {
+    for (int x = 0; x < 100; x++)
+      m.matrix[y][x] /= 100.0;
+    m.matrix[y][y] += 1;
+  }
+
+  // Время замеряет make bench (--ops calc_complements).
+  ck_assert_int_eq(s21_calc_complements(&m, &c), 0);
+
+  // A * C^T = det(A) * I.
+  double det;
+  s21_determinant(&m, &det);
+  for (int y = 0; y < 100; y++)
+    for (int x = 0; x < 100; x++) {
+      double sum = 0;
+      for (int k = 0; k < 100; k++)
+        sum += m.matrix[y][k] * c.matrix[x][k];
+      ck_assert_double_eq_tol(sum, y == x ? det : 0, 1e-9 * fabs(det));
+    }
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&c);
+}
+END_TEST
+
 START_TEST(inverse_matrix_1) {
   matrix_t m, n, k, l;
   s21_create_matrix(3, 3, &m);
@@ -1160,6 +1606,1302 @@ START_TEST(inverse_matrix_7) {
 }
 END_TEST
 
+START_TEST(inverse_matrix_gauss_jordan) {
+  matrix_t m, n, k;
+  s21_create_matrix(1, 1, &m);
+  m.matrix[0][0] = 4;
+  ck_assert_int_eq(s21_inverse_matrix(&m, &n), 0);
+  ck_assert_double_eq_tol(n.matrix[0][0], 0.25, 1e-12);
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&n);
+
+  s21_create_matrix(40, 40, &m);
+  fill_random(&m, 40);
+  ck_assert_int_eq(s21_inverse_matrix(&m, &n), 0);
+  s21_mult_matrix(&m, &n, &k);
+  for (int y = 0; y < 40; y++)
+    for (int x = 0; x < 40; x++)
+      ck_assert_double_eq_tol(k.matrix[y][x], y == x ? 1 : 0, 1e-9);
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&n);
+  s21_remove_matrix(&k);
+}
+END_TEST
+
+START_TEST(inverse_matrix_singular_scaled) {
+  // Вырожденность определяется относительно масштаба матрицы.
+  matrix_t m, n;
+  s21_create_matrix(3, 3, &m);
+  fill(&m, 1);
+  for (int y = 0; y < 3; y++)
+    for (int x = 0; x < 3; x++)
+      m.matrix[y][x] *= 1e12;
+  ck_assert_int_eq(s21_inverse_matrix(&m, &n), 2);
+  ck_assert_int_eq(n.rows, 0);
+
+  for (int y = 0; y < 3; y++)
+    for (int x = 0; x < 3; x++)
+      m.matrix[y][x] = (y == x) * 1e-12;
+  ck_assert_int_eq(s21_inverse_matrix(&m, &n), 0);
+  ck_assert_double_eq_tol(n.matrix[1][1], 1e12, 1);
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&n);
+}
+END_TEST
+
+START_TEST(lu_factor_solve) {
+  // 150 строк - несколько блоков LU_SOLVE_NB, 70 правых частей за один вызов.
+  matrix_t a, b, x, check, inv;
+  s21_lu_t lu;
+  s21_create_matrix(150, 150, &a);
+  s21_create_matrix(150, 70, &b);
+  fill_random(&a, 21);
+  fill_random(&b, 22);
+
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), 0);
+  ck_assert_int_eq(s21_lu_singular(&lu), 0);
+  ck_assert_int_eq(s21_lu_solve(&lu, &b, &x), 0);
+  s21_mult_matrix(&a, &x, &check);
+  for (int y = 0; y < 150; y++)
+    for (int c = 0; c < 70; c++)
+      ck_assert_double_eq_tol(check.matrix[y][c], b.matrix[y][c], 1e-8);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&x);
+
+  ck_assert_int_eq(s21_lu_inverse(&lu, &inv), 0);
+  s21_mult_matrix(&inv, &a, &check);
+  for (int y = 0; y < 150; y++)
+    for (int c = 0; c < 150; c++)
+      ck_assert_double_eq_tol(check.matrix[y][c], y == c, 1e-8);
+  s21_remove_matrix(&check);
+  s21_remove_matrix(&inv);
+
+  matrix_t wrong;
+  s21_create_matrix(149, 2, &wrong);
+  ck_assert_int_eq(s21_lu_solve(&lu, &wrong, &x), 2);
+  s21_remove_matrix(&wrong);
+  s21_lu_free(&lu);
+  ck_assert_int_eq(s21_lu_solve(&lu, &b, &x), 1);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(lu_det_singular) {
+  matrix_t a, b, x;
+  s21_lu_t lu;
+  double d1, d2;
+  s21_create_matrix(9, 9, &a);
+  fill_random(&a, 9);
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), 0);
+  ck_assert_int_eq(s21_lu_det(&lu, &d1), 0);
+  s21_determinant(&a, &d2);
+  ck_assert_double_eq_tol(d1, d2, 1e-9 * fabs(d2));
+  s21_lu_free(&lu);
+
+  for (int x = 0; x < 9; x++)
+    a.matrix[4][x] = a.matrix[2][x] * 3;
+  s21_create_matrix(9, 1, &b);
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), 0);
+  ck_assert_int_eq(s21_lu_singular(&lu), 1);
+  ck_assert_int_eq(s21_lu_solve(&lu, &b, &x), 2);
+  ck_assert_int_eq(s21_lu_inverse(&lu, &x), 2);
+  s21_lu_det(&lu, &d1);
+  ck_assert_double_eq_tol(d1, 0, 1e-6);
+  s21_lu_free(&lu);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&a);
+
+  s21_create_matrix(2, 3, &a);
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), 2);
+  s21_remove_matrix(&a);
+  ck_assert_int_eq(s21_lu_factor(&a, &lu), 1);
+  ck_assert_int_eq(s21_lu_det(&lu, &d1), 1);
+}
+END_TEST
+
+START_TEST(transpose_tiled) {
+  // Все уровни SIMD, размеры не кратны ни тайлу, ни ширине регистра.
+  int sizes[][2] = {{1, 1}, {1, 9}, {7, 3}, {33, 65}, {130, 41}};
+  for (int level = S21_SIMD_SCALAR; level <= s21_simd_supported(); level++) {
+    s21_set_simd_level(level);
+    for (int s = 0; s < 5; s++) {
+      matrix_t a, t;
+      s21_create_matrix(sizes[s][0], sizes[s][1], &a);
+      fill_random(&a, s + 40);
+      ck_assert_int_eq(s21_transpose(&a, &t), 0);
+      ck_assert_int_eq(t.rows, a.columns);
+      ck_assert_int_eq(t.columns, a.rows);
+      for (int y = 0; y < a.rows; y++)
+        for (int x = 0; x < a.columns; x++)
+          ck_assert_double_eq(t.matrix[x][y], a.matrix[y][x]);
+      s21_remove_matrix(&t);
+      s21_remove_matrix(&a);
+    }
+  }
+  s21_set_simd_level(-1);
+}
+END_TEST
+
+START_TEST(transpose_inplace) {
+  int sizes[][2] = {{1, 1}, {70, 70}, {1, 50}, {50, 1}, {3, 100}, {67, 31}};
+  for (int s = 0; s < 6; s++) {
+    matrix_t a, t;
+    s21_create_matrix(sizes[s][0], sizes[s][1], &a);
+    fill_random(&a, s + 60);
+    s21_transpose(&a, &t);
+    ck_assert_int_eq(s21_transpose_inplace(&a), 0);
+    ck_assert_int_eq(a.rows, sizes[s][1]);
+    ck_assert_int_eq(a.columns, sizes[s][0]);
+    ck_assert_int_eq((uintptr_t)a.matrix[0] % MATRIX_ALIGN, 0);
+    ck_assert_int_eq(s21_eq_matrix(&a, &t), SUCCESS);
+    s21_remove_matrix(&t);
+    s21_remove_matrix(&a);
+  }
+
+  // В арене массиву строк некуда расти - отказ без изменений, сжатие проходит.
+  s21_arena_t *arena = s21_arena_create(0);
+  matrix_t a, t;
+  s21_create_matrix_in(arena, 2, 40, &a);
+  fill_random(&a, 7);
+  s21_transpose(&a, &t);
+  ck_assert_int_eq(s21_transpose_inplace(&a), 2);
+  ck_assert_int_eq(a.rows, 2);
+  ck_assert_double_eq(a.matrix[1][39], t.matrix[39][1]);
+  s21_create_matrix_in(arena, 40, 2, &a);
+  memcpy(a.matrix[0], t.matrix[0], sizeof(double) * 80);
+  ck_assert_int_eq(s21_transpose_inplace(&a), 0);
+  ck_assert_int_eq(a.rows, 2);
+  ck_assert_double_eq(a.matrix[1][39], t.matrix[39][1]);
+  s21_remove_matrix(&t);
+  s21_arena_destroy(arena);
+
+  matrix_t empty = {NULL, 0, 0, 0};
+  ck_assert_int_eq(s21_transpose_inplace(&empty), 1);
+}
+END_TEST
+
+START_TEST(transpose_lazy) {
+  matrix_t a, b, at, bt, ref, res, tmp;
+  s21_create_matrix(37, 23, &a);
+  s21_create_matrix(37, 23, &b);
+  fill_random(&a, 81);
+  fill_random(&b, 82);
+  ck_assert_int_eq(s21_transpose_lazy(&a, &at), 0);
+  ck_assert_int_eq(s21_transpose_lazy(&b, &bt), 0);
+  ck_assert_ptr_eq(at.matrix, a.matrix);
+  ck_assert_int_eq(at.rows, 23);
+  ck_assert_int_eq(at.columns, 37);
+
+  // A^T * B и A * B^T без материализации A^T.
+  s21_transpose(&a, &tmp);
+  ck_assert_int_eq(s21_mult_matrix(&at, &b, &res), 0);
+  s21_mult_matrix(&tmp, &b, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&res, &ref), SUCCESS);
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&ref);
+  ck_assert_int_eq(s21_mult_matrix(&a, &bt, &res), 0);
+  s21_mult_matrix(&a, &tmp, &ref);
+  ck_assert_int_eq(res.rows, 37);
+  ck_assert_int_eq(s21_eq_matrix(&tmp, &at), SUCCESS);
+  ck_assert_int_eq(s21_eq_matrix(&at, &tmp), SUCCESS);
+  ck_assert_int_eq(s21_eq_matrix(&at, &a), FAILURE);
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&ref);
+
+  // Сумма и разность при любой комбинации ориентаций.
+  ck_assert_int_eq(s21_sum_matrix(&at, &tmp, &res), 0);
+  ck_assert_double_eq(res.matrix[5][30], 2 * a.matrix[30][5]);
+  s21_remove_matrix(&res);
+  ck_assert_int_eq(s21_sub_matrix(&tmp, &bt, &res), 0);
+  ck_assert_double_eq(res.matrix[5][30], a.matrix[30][5] - b.matrix[30][5]);
+  s21_remove_matrix(&res);
+  ck_assert_int_eq(s21_sum_matrix(&at, &bt, &res), 0);
+  ck_assert_double_eq(res.matrix[22][36], a.matrix[36][22] + b.matrix[36][22]);
+  ck_assert_int_eq(s21_sum_matrix(&at, &a, &ref), 2);
+  s21_remove_matrix(&res);
+  ck_assert_int_eq(s21_axpy(-1, &at, &tmp), 0);
+  ck_assert_double_eq(tmp.matrix[22][36], 0);
+  ck_assert_int_eq(s21_transpose(&at, &res), 0);
+  ck_assert_int_eq(s21_eq_matrix(&res, &a), SUCCESS);
+  s21_remove_matrix(&res);
+
+  // Ленивая матрица не владеет памятью, C в s21_gemm должна быть обычной.
+  matrix_t square, st;
+  s21_create_matrix(6, 6, &square);
+  fill_random(&square, 83);
+  s21_transpose_lazy(&square, &st);
+  double d1, d2;
+  s21_determinant(&square, &d1);
+  s21_determinant(&st, &d2);
+  ck_assert_double_eq_tol(d1, d2, 1e-9);
+  ck_assert_int_eq(s21_gemm(1, &square, &square, 0, &st), 2);
+  ck_assert_int_eq(s21_inverse_matrix(&st, &res), 0);
+  s21_mult_matrix(&res, &st, &ref);
+  for (int y = 0; y < 6; y++)
+    ck_assert_double_eq_tol(ref.matrix[y][y], 1, 1e-9);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&res);
+  s21_remove_matrix(&st);
+  ck_assert_ptr_nonnull(square.matrix);
+
+  // На самой матрице флаг ставится без передачи владения.
+  ck_assert_int_eq(s21_transpose_lazy(&square, &square), 0);
+  ck_assert_int_eq(s21_transpose_inplace(&square), 0);
+  ck_assert_int_eq(square.flags, 0);
+
+  // Два ленивых транспонирования дают чужое нетранспонированное хранилище: in-place меняет
+  // только ориентацию и не трогает память владельца (ни 2x5, ни квадратного).
+  matrix_t wide, copy, t1, t2;
+  s21_create_matrix(2, 5, &wide);
+  fill_random(&wide, 89);
+  matrix_t *owners[2] = {&wide, &square};
+  for (int i = 0; i < 2; i++) {
+    s21_transpose(owners[i], &ref);
+    s21_transpose(&ref, &copy);
+    s21_transpose_lazy(owners[i], &t1);
+    s21_transpose_lazy(&t1, &t2);
+    ck_assert_int_eq(s21_transpose_inplace(&t2), 0);
+    ck_assert_ptr_eq(t2.matrix, owners[i]->matrix);
+    ck_assert_int_eq(t2.rows, owners[i]->columns);
+    ck_assert_int_eq(s21_eq_matrix(&t2, &ref), SUCCESS);
+    ck_assert_int_eq(memcmp(owners[i]->matrix[0], copy.matrix[0],
+                            sizeof(double) * copy.rows * copy.columns), 0);
+    s21_remove_matrix(&t2);
+    s21_remove_matrix(&t1);
+    s21_remove_matrix(&ref);
+    s21_remove_matrix(&copy);
+  }
+  s21_remove_matrix(&wide);
+  s21_remove_matrix(&square);
+
+  s21_remove_matrix(&tmp);
+  s21_remove_matrix(&at);
+  s21_remove_matrix(&bt);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(batch_small_matrices) {
+  // 1003 матрицы - последняя группа неполная, задач пула несколько.
+  const int count = 1003;
+  for (int level = S21_SIMD_SCALAR; level <= s21_simd_supported(); level++) {
+    s21_set_simd_level(level);
+    for (int n = 1; n <= S21_BATCH_MAX; n++) {
+      s21_batch_t a, b, prod, inv;
+      double *det = malloc(sizeof(double) * count);
+      ck_assert_int_eq(s21_batch_create(count, n, n, &a), 0);
+      ck_assert_int_eq(s21_batch_create(count, n, n, &b), 0);
+      for (int k = 0; k < count; k++) {
+        matrix_t m;
+        s21_create_matrix(n, n, &m);
+        fill_random(&m, k * 7 + n);
+        for (int i = 0; i < n; i++)
+          m.matrix[i][i] += 100;
+        s21_batch_set(&a, k, &m);
+        fill_random(&m, k * 7 + n + 1);
+        s21_batch_set(&b, k, &m);
+        s21_remove_matrix(&m);
+      }
+      ck_assert_int_eq(s21_batch_inverse(&a, &inv), 0);
+      // Одна вырожденная матрица: определитель 0, обращение пакета - код 2 без результата.
+      matrix_t zero;
+      s21_batch_t again;
+      s21_create_matrix(n, n, &zero);
+      s21_batch_set(&a, 500, &zero);
+      s21_remove_matrix(&zero);
+
+      ck_assert_int_eq(s21_batch_mult(&a, &b, &prod), 0);
+      ck_assert_int_eq(s21_batch_det(&a, det), 0);
+      ck_assert_int_eq(s21_batch_inverse(&a, &again), 2);
+      ck_assert_ptr_null(again.data);
+      for (int k = 0; k < count; k += 37) {
+        matrix_t ma, mb, mp, mi, ref;
+        double d;
+        s21_batch_get(&a, k, &ma);
+        s21_batch_get(&b, k, &mb);
+        s21_batch_get(&prod, k, &mp);
+        s21_batch_get(&inv, k, &mi);
+        s21_mult_matrix(&ma, &mb, &ref);
+        ck_assert_int_eq(s21_eq_matrix(&mp, &ref), SUCCESS);
+        s21_remove_matrix(&ref);
+        s21_determinant(&ma, &d);
+        ck_assert_double_eq_tol(det[k], d, 1e-9 * (fabs(d) + 1));
+        ck_assert_int_eq(s21_inverse_matrix(&ma, &ref), 0);
+        ck_assert_int_eq(s21_eq_matrix(&mi, &ref), SUCCESS);
+        s21_remove_matrix(&ref);
+        s21_remove_matrix(&ma);
+        s21_remove_matrix(&mb);
+        s21_remove_matrix(&mp);
+        s21_remove_matrix(&mi);
+      }
+      ck_assert_double_eq(det[500], 0);
+      s21_batch_remove(&a);
+      s21_batch_remove(&b);
+      s21_batch_remove(&prod);
+      s21_batch_remove(&inv);
+      free(det);
+    }
+  }
+  s21_set_simd_level(-1);
+}
+END_TEST
+
+START_TEST(batch_shapes) {
+  s21_batch_t a, b, c;
+  matrix_t m, wrong;
+  ck_assert_int_eq(s21_batch_create(10, S21_BATCH_MAX + 1, 2, &a), 1);
+  ck_assert_int_eq(s21_batch_create(0, 2, 2, &a), 1);
+  ck_assert_int_eq(s21_batch_mult(&a, &a, &c), 1);
+  ck_assert_int_eq(s21_batch_create(10, 2, 3, &a), 0);
+  ck_assert_int_eq(s21_batch_create(10, 3, 5, &b), 0);
+  s21_create_matrix(2, 3, &m);
+  s21_create_matrix(3, 2, &wrong);
+  fill(&m, 1);
+  ck_assert_int_eq(s21_batch_set(&a, 10, &m), 2);
+  ck_assert_int_eq(s21_batch_set(&a, 0, &wrong), 2);
+  ck_assert_int_eq(s21_batch_set(&a, 9, &m), 0);
+  fill(&wrong, 2);
+  ck_assert_int_eq(s21_batch_set(&b, 9, &wrong), 2);
+
+  // Прямоугольные множители - общий путь ядра.
+  matrix_t mb, ref, got;
+  s21_create_matrix(3, 5, &mb);
+  fill(&mb, 3);
+  s21_batch_set(&b, 9, &mb);
+  ck_assert_int_eq(s21_batch_mult(&a, &b, &c), 0);
+  ck_assert_int_eq(c.rows, 2);
+  ck_assert_int_eq(c.columns, 5);
+  s21_batch_get(&c, 9, &got);
+  s21_mult_matrix(&m, &mb, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_batch_remove(&c);
+  ck_assert_int_eq(s21_batch_mult(&b, &a, &c), 2);
+  double det[10];
+  ck_assert_int_eq(s21_batch_det(&a, det), 2);
+  ck_assert_int_eq(s21_batch_inverse(&a, &c), 2);
+  ck_assert_ptr_null(c.data);
+
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&mb);
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&wrong);
+  s21_batch_remove(&a);
+  s21_batch_remove(&b);
+}
+END_TEST
+
+START_TEST(fixed_size_kernels) {
+  for (int n = 2; n <= 4; n++) {
+    matrix_t a, b, got, ref, inv;
+    s21_lu_t lu;
+    double det = 0;
+    s21_create_matrix(n, n, &a);
+    s21_create_matrix(n, n, &b);
+    fill_random(&a, n);
+    fill_random(&b, n + 10);
+
+    ck_assert_int_eq(s21_determinant(&a, &det), 0);
+    ck_assert_double_eq_tol(det, ref_determinant(&a), 1e-9 * fabs(det) + 1e-9);
+    ck_assert_int_eq(s21_mult_matrix(&a, &b, &got), 0);
+    ref_mult_matrix(&a, &b, &ref);
+    ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+    s21_remove_matrix(&got);
+    s21_remove_matrix(&ref);
+
+    ck_assert_int_eq(s21_inverse_matrix(&a, &got), 0);
+    s21_lu_factor(&a, &lu);
+    s21_lu_inverse(&lu, &inv);
+    ck_assert_int_eq(s21_eq_matrix(&got, &inv), SUCCESS);
+    s21_lu_free(&lu);
+    s21_remove_matrix(&inv);
+    s21_remove_matrix(&got);
+
+    // Ленивое транспонирование учитывается при переносе в фиксированный тип.
+    matrix_t t = {NULL, 0, 0, 0}, dense;
+    s21_transpose(&a, &dense);
+    s21_transpose_lazy(&a, &t);
+    ck_assert_int_eq(s21_mult_matrix(&t, &b, &got), 0);
+    ref_mult_matrix(&dense, &b, &ref);
+    ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+    ck_assert_int_eq(s21_determinant(&t, &det), 0);
+    ck_assert_double_eq_tol(det, ref_determinant(&dense), 1e-9 * fabs(det) + 1e-9);
+    s21_remove_matrix(&got);
+    s21_remove_matrix(&ref);
+    s21_remove_matrix(&dense);
+    s21_remove_matrix(&t);
+
+    // Вырожденная матрица: результат не создаётся.
+    fill(&a, 0);
+    ck_assert_int_eq(s21_inverse_matrix(&a, &got), 2);
+    ck_assert_ptr_null(got.matrix);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+  }
+
+  // Почти вырожденная 4x4: |det| выше EPS * max|a|^4, но ведущий элемент метода Гаусса
+  // ниже порога - код тот же, что у метода Гаусса-Жордана.
+  double near[4][4] = {{3, 3, 2, -3}, {3, 3, -3, 1}, {-3, 3, -2, 2}, {2.999999112, -3, -3, 2}};
+  matrix_t a, got;
+  s21_create_matrix(4, 4, &a);
+  for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+      a.matrix[y][x] = near[y][x];
+  ck_assert_int_eq(s21_inverse_matrix(&a, &got), 2);
+  ck_assert_ptr_null(got.matrix);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(fixed_size_types) {
+  s21_mat3_t a = {{{2, 5, 7}, {6, 3, 4}, {5, -2, -3}}}, inv, id;
+  s21_mat4_t b = {{{1, 2, 3, 4}, {2, 4, 6, 8}, {0, 1, 0, 1}, {1, 0, 0, 2}}}, binv;
+  s21_mat2_t c = {{{4, 7}, {2, 6}}}, c2;
+  matrix_t m, wrong;
+
+  ck_assert_double_eq_tol(s21_fixed_det(&a), -1, 1e-12);
+  ck_assert_int_eq(s21_fixed_inverse(&a, &inv), 0);
+  s21_fixed_mult(&a, &inv, &id);
+  for (int y = 0; y < 3; y++)
+    for (int x = 0; x < 3; x++)
+      ck_assert_double_eq_tol(id.m[y][x], y == x, 1e-12);
+  ck_assert_double_eq(s21_fixed_det(&b), 0);
+  ck_assert_int_eq(s21_fixed_inverse(&b, &binv), 2);
+
+  ck_assert_int_eq(s21_fixed_to(&c, &m), 0);
+  ck_assert_int_eq(s21_fixed_from(&m, &c2), 0);
+  ck_assert_int_eq(memcmp(&c, &c2, sizeof(c)), 0);
+  ck_assert_int_eq(s21_fixed_from(&m, &a), 2);
+  s21_remove_matrix(&m);
+  wrong.matrix = NULL;
+  wrong.rows = 0;
+  ck_assert_int_eq(s21_fixed_from(&wrong, &c2), 1);
+}
+END_TEST
+
+START_TEST(stats_counters) {
+  s21_stats_t st;
+  matrix_t a, b, c;
+  char json[4096] = {0};
+  FILE *f = tmpfile();
+
+  s21_stats_reset();
+  s21_create_matrix(8, 8, &a);
+  s21_create_matrix(8, 8, &b);
+  s21_mult_matrix(&a, &b, &c);
+  int ret = s21_stats_snapshot(&st);
+#ifdef S21_STATS
+  ck_assert_int_eq(ret, 0);
+  ck_assert_int_eq(st.enabled, 1);
+  ck_assert_uint_ge(st.functions[S21_STAT_create_matrix].calls, 3);
+  ck_assert_uint_eq(st.functions[S21_STAT_mult_matrix].calls, 1);
+  ck_assert_uint_eq(st.functions[S21_STAT_mult_matrix].flops, 2 * 8 * 8 * 8);
+  ck_assert_uint_ge(st.bytes_allocated, 3 * 8 * 8 * sizeof(double));
+  ck_assert_int_ge(st.peak_live_matrices, st.live_matrices);
+  int64_t live = st.live_matrices;
+  s21_remove_matrix(&c);
+  s21_stats_snapshot(&st);
+  ck_assert_int_eq(st.live_matrices, live - 1);
+  ck_assert_uint_gt(st.bytes_freed, 0);
+#else
+  ck_assert_int_eq(ret, 1);
+  ck_assert_int_eq(st.enabled, 0);
+  ck_assert_uint_eq(st.functions[S21_STAT_mult_matrix].calls, 0);
+  s21_remove_matrix(&c);
+#endif
+  ck_assert_str_eq(s21_stats_name(S21_STAT_gemm), "gemm");
+  ck_assert_ptr_null(s21_stats_name(S21_STAT_COUNT));
+  ck_assert_int_eq(s21_stats_dump_json(f), 0);
+  rewind(f);
+  ck_assert_int_gt(fread(json, 1, sizeof(json) - 1, f), 0);
+  ck_assert_ptr_nonnull(strstr(json, "\"mult_matrix\": {\"calls\": "));
+  ck_assert_ptr_nonnull(strstr(json, "\"peak_live_matrices\": "));
+  fclose(f);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(sparse_formats) {
+  matrix_t a, t = {NULL, 0, 0, 0}, back, dense_t;
+  s21_sparse_t csr, csc, conv, tr;
+  s21_create_matrix(5, 7, &a);
+  a.matrix[0][3] = 1.5;
+  a.matrix[2][0] = -2;
+  a.matrix[2][6] = 4;
+  a.matrix[4][3] = 7;
+
+  ck_assert_int_eq(s21_sparse_from_matrix(&a, S21_CSR, &csr), 0);
+  ck_assert_int_eq(csr.nnz, 4);
+  ck_assert_int_eq(csr.offsets[5], 4);
+  ck_assert_int_eq(s21_sparse_to_matrix(&csr, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&a, &back), SUCCESS);
+  s21_remove_matrix(&back);
+
+  ck_assert_int_eq(s21_sparse_convert(&csr, S21_CSC, &csc), 0);
+  ck_assert_int_eq(csc.format, S21_CSC);
+  ck_assert_int_eq(csc.offsets[3], 1);
+  ck_assert_int_eq(csc.offsets[4], 3);
+  ck_assert_int_eq(csc.indices[1], 0);
+  ck_assert_int_eq(csc.indices[2], 4);
+  ck_assert_int_eq(s21_sparse_to_matrix(&csc, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&a, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  ck_assert_int_eq(s21_sparse_convert(&csc, S21_CSC, &conv), 0);
+  ck_assert_int_eq(conv.nnz, 4);
+  s21_sparse_remove(&conv);
+
+  // Транспонирование в обоих форматах и из лениво транспонированной matrix_t.
+  s21_transpose(&a, &dense_t);
+  s21_transpose_lazy(&a, &t);
+  ck_assert_int_eq(s21_sparse_transpose(&csr, &tr), 0);
+  ck_assert_int_eq(tr.rows, 7);
+  ck_assert_int_eq(s21_sparse_to_matrix(&tr, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&dense_t, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  s21_sparse_remove(&tr);
+  ck_assert_int_eq(s21_sparse_transpose(&csc, &tr), 0);
+  ck_assert_int_eq(s21_sparse_to_matrix(&tr, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&dense_t, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  s21_sparse_remove(&tr);
+  ck_assert_int_eq(s21_sparse_from_matrix(&t, S21_CSC, &tr), 0);
+  ck_assert_int_eq(s21_sparse_to_matrix(&tr, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&dense_t, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  s21_sparse_remove(&tr);
+
+  ck_assert_int_eq(s21_sparse_from_matrix(&a, 5, &tr), 1);
+  ck_assert_int_eq(s21_sparse_create(0, 3, 0, S21_CSR, &tr), 1);
+  ck_assert_int_eq(s21_sparse_to_matrix(&tr, &back), 1);
+  s21_remove_matrix(&dense_t);
+  s21_remove_matrix(&a);
+  s21_sparse_remove(&csr);
+  s21_sparse_remove(&csc);
+}
+END_TEST
+
+START_TEST(sparse_products) {
+  matrix_t a, b, ref, got, sum;
+  s21_sparse_t csr, csc, other, res;
+  double x[40], y[60], y_ref[60];
+  s21_create_matrix(60, 40, &a);
+  s21_create_matrix(40, 9, &b);
+  fill_random(&b, 3);
+  for (int i = 0; i < 60; i++) {
+    a.matrix[i][(i * 7) % 40] = i + 1;
+    a.matrix[i][(i * 13 + 5) % 40] = -0.5 * i;
+  }
+  for (int j = 0; j < 40; j++)
+    x[j] = j - 20.5;
+  s21_sparse_from_matrix(&a, S21_CSR, &csr);
+  s21_sparse_from_matrix(&a, S21_CSC, &csc);
+  s21_mult_matrix(&a, &b, &ref);
+  for (int i = 0; i < 60; i++) {
+    y_ref[i] = 0;
+    for (int j = 0; j < 40; j++)
+      y_ref[i] += a.matrix[i][j] * x[j];
+  }
+
+  for (int f = 0; f < 2; f++) {
+    s21_sparse_t *s = f ? &csc : &csr;
+    ck_assert_int_eq(s21_sparse_mult_vector(s, x, y), 0);
+    for (int i = 0; i < 60; i++)
+      ck_assert_double_eq_tol(y[i], y_ref[i], 1e-9);
+    ck_assert_int_eq(s21_sparse_mult_matrix(s, &b, &got), 0);
+    ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+    s21_remove_matrix(&got);
+  }
+  ck_assert_int_eq(s21_sparse_mult_matrix(&csr, &a, &got), 2);
+  s21_sparse_remove(&csc);
+
+  // Сумма разных форматов: совпадающие позиции складываются, нули от сокращения остаются в структуре.
+  matrix_t neg;
+  s21_mult_number(&a, -1, &neg);
+  neg.matrix[3][0] = 9;
+  s21_sparse_from_matrix(&neg, S21_CSC, &other);
+  ck_assert_int_eq(s21_sparse_sum(&csr, &other, &res), 0);
+  ck_assert_int_eq(res.format, S21_CSR);
+  ck_assert_int_eq(s21_sparse_to_matrix(&res, &got), 0);
+  s21_sum_matrix(&a, &neg, &sum);
+  ck_assert_int_eq(s21_eq_matrix(&got, &sum), SUCCESS);
+  ck_assert_int_eq(s21_sparse_sum(&csr, &res, &csc), 0);
+  s21_sparse_remove(&csc);
+  s21_sparse_remove(&res);
+  s21_sparse_remove(&other);
+  s21_sparse_remove(&csr);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&sum);
+  s21_remove_matrix(&neg);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(file_save_load) {
+  const char *path = "s21_test_matrix.bin";
+  matrix_t a, t, back;
+  s21_create_matrix(7, 5, &a);
+  fill_random(&a, 11);
+  ck_assert_int_eq(s21_save_matrix(&a, path), 0);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&a, &back), SUCCESS);
+  s21_remove_matrix(&back);
+
+  // Ленивое транспонирование пишется в логическом порядке.
+  s21_transpose_lazy(&a, &t);
+  ck_assert_int_eq(s21_save_matrix(&t, path), 0);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 0);
+  ck_assert_int_eq(back.rows, 5);
+  ck_assert_int_eq(s21_eq_matrix(&t, &back), SUCCESS);
+  s21_remove_matrix(&back);
+
+  // Файл с обратным порядком байтов: загрузка переставляет байты, отображение отказывает.
+  unsigned char raw[64 + 35 * sizeof(double)];
+  FILE *f = fopen(path, "rb");
+  ck_assert_uint_eq(fread(raw, 1, sizeof(raw), f), sizeof(raw));
+  fclose(f);
+  for (size_t k = 8; k < sizeof(raw); k += k < 24 ? 4 : 8) {
+    size_t w = k < 24 ? 4 : 8;
+    for (size_t m = 0; m < w / 2; m++) {
+      unsigned char c = raw[k + m];
+      raw[k + m] = raw[k + w - 1 - m];
+      raw[k + w - 1 - m] = c;
+    }
+  }
+  f = fopen(path, "wb");
+  fwrite(raw, 1, sizeof(raw), f);
+  fclose(f);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&t, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  ck_assert_int_eq(s21_mmap_matrix(path, &back), 2);
+
+  // Обрезанный файл, чужой файл и отсутствующий файл.
+  f = fopen(path, "wb");
+  fwrite(raw, 1, 100, f);
+  fclose(f);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 2);
+  ck_assert_int_eq(s21_mmap_matrix(path, &back), 2);
+  ck_assert_ptr_null(back.matrix);
+  raw[0] = 'X';
+  f = fopen(path, "wb");
+  fwrite(raw, 1, sizeof(raw), f);
+  fclose(f);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 2);
+  remove(path);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 2);
+  ck_assert_int_eq(s21_mmap_matrix(path, &back), 2);
+  ck_assert_int_eq(s21_save_matrix(&back, path), 1);
+  s21_remove_matrix(&t);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(file_mmap) {
+  const char *path = "s21_test_matrix_map.bin";
+  matrix_t a, b, m, ref, got, back;
+  s21_create_matrix(6, 4, &a);
+  s21_create_matrix(4, 3, &b);
+  fill_random(&a, 5);
+  fill_random(&b, 6);
+  s21_save_matrix(&a, path);
+  ck_assert_int_eq(s21_mmap_matrix(path, &m), 0);
+  ck_assert_int_eq(s21_eq_matrix(&a, &m), SUCCESS);
+  s21_mult_matrix(&a, &b, &ref);
+  ck_assert_int_eq(s21_mult_matrix(&m, &b, &got), 0);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+
+  // Изменения отображённой матрицы остаются в процессе, файл не меняется.
+  ck_assert_int_eq(s21_mult_number_inplace(&m, 2), 0);
+  ck_assert_double_eq_tol(m.matrix[5][3], 2 * a.matrix[5][3], 1e-12);
+  ck_assert_int_eq(s21_transpose_inplace(&m), 0);
+  ck_assert_int_eq(m.rows, 4);
+  ck_assert_double_eq_tol(m.matrix[3][5], 2 * a.matrix[5][3], 1e-12);
+  ck_assert_int_eq(s21_load_matrix(path, &back), 0);
+  ck_assert_int_eq(s21_eq_matrix(&a, &back), SUCCESS);
+  s21_remove_matrix(&back);
+  s21_remove_matrix(&m);
+  ck_assert_ptr_null(m.matrix);
+  remove(path);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(text_round_trip) {
+  matrix_t a, t, back;
+  s21_text_options_t csv = {S21_TEXT_CSV, 0}, tsv = {S21_TEXT_TSV, 4};
+  s21_create_matrix(30, 7, &a);
+  fill_random(&a, 21);
+  a.matrix[0][0] = 0.1;
+  a.matrix[0][1] = -1e-300;
+  a.matrix[0][2] = 123456789012345678.0;
+  a.matrix[0][3] = 5e-324;
+
+  // Кратчайшая запись читается обратно точно во всех форматах, транспонированная - по строкам.
+  s21_transpose_lazy(&a, &t);
+  for (int k = 0; k < 2; k++) {
+    FILE *f = tmpfile();
+    ck_assert_int_eq(s21_write_matrix_text(f, k ? &t : &a, k ? &csv : NULL), 0);
+    rewind(f);
+    ck_assert_int_eq(s21_read_matrix_text(f, k ? &csv : NULL, 0, &back), 0);
+    ck_assert_int_eq(back.rows, k ? 7 : 30);
+    for (int y = 0; y < back.rows; y++)
+      for (int x = 0; x < back.columns; x++)
+        ck_assert(back.matrix[y][x] == (k ? a.matrix[x][y] : a.matrix[y][x]));
+    s21_remove_matrix(&back);
+    fclose(f);
+  }
+
+  // Блоками по 8 строк: 8 + 8 + 8 + 6, затем 1 - строк не осталось.
+  FILE *f = tmpfile();
+  s21_write_matrix_text(f, &a, &tsv);
+  rewind(f);
+  int total = 0;
+  while (s21_read_matrix_text(f, &tsv, 8, &back) == 0) {
+    ck_assert_int_le(back.rows, 8);
+    for (int y = 0; y < back.rows; y++)
+      ck_assert_double_eq_tol(back.matrix[y][6], a.matrix[total + y][6],
+                              1e-3 * fabs(a.matrix[total + y][6]));
+    total += back.rows;
+    s21_remove_matrix(&back);
+  }
+  ck_assert_int_eq(total, 30);
+  fclose(f);
+  tsv.precision = 18;
+  ck_assert_int_eq(s21_write_matrix_text(stdout, &a, &tsv), 1);
+  s21_remove_matrix(&t);
+  s21_remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(text_parse) {
+  matrix_t m;
+  s21_text_options_t csv = {S21_TEXT_CSV, 0}, tsv = {S21_TEXT_TSV, 0};
+  const char *ok = "\n 1, -2.5 ,3e2\r\n\n.5,+4.,-0.0001E-3\n"
+                   "1.7976931348623157e308,123456789012345678901,inf\n";
+  FILE *f = tmpfile();
+  fputs(ok, f);
+  rewind(f);
+  ck_assert_int_eq(s21_read_matrix_text(f, &csv, 0, &m), 0);
+  ck_assert_int_eq(m.rows, 3);
+  ck_assert_int_eq(m.columns, 3);
+  ck_assert(m.matrix[0][1] == -2.5 && m.matrix[0][2] == 300 && m.matrix[1][0] == 0.5);
+  ck_assert(m.matrix[1][1] == 4 && m.matrix[1][2] == strtod("-0.0001E-3", NULL));
+  ck_assert(m.matrix[2][0] == 1.7976931348623157e308 && m.matrix[2][1] == 123456789012345678901.0);
+  ck_assert(isinf(m.matrix[2][2]));
+  s21_remove_matrix(&m);
+  fclose(f);
+
+  // Быстрый разбор совпадает с strtod до последнего бита.
+  char buf[64];
+  unsigned state = 1;
+  for (int k = 0; k < 2000; k++) {
+    state = state * 1103515245u + 12345u;
+    double v = ((int)(state >> 8) - (1 << 23)) * pow(10, (int)(state % 40) - 20) / 7;
+    snprintf(buf, sizeof(buf), k % 2 ? "%.17g" : "%.6f", v);
+    f = tmpfile();
+    fputs(buf, f);
+    rewind(f);
+    ck_assert_int_eq(s21_read_matrix_text(f, NULL, 0, &m), 0);
+    ck_assert(m.matrix[0][0] == strtod(buf, NULL));
+    s21_remove_matrix(&m);
+    fclose(f);
+  }
+
+  const char *bad[] = {"1,2\n3\n", "1,,2\n", "1,x\n", "1 2\n", "\n\n"};
+  for (int k = 0; k < 5; k++) {
+    f = tmpfile();
+    fputs(bad[k], f);
+    rewind(f);
+    ck_assert_int_eq(s21_read_matrix_text(f, &csv, 0, &m), k < 4 ? 2 : 1);
+    ck_assert_ptr_null(m.matrix);
+    fclose(f);
+  }
+  f = tmpfile();
+  fputs("1 2\t3\n4\t5 6\n", f);
+  rewind(f);
+  ck_assert_int_eq(s21_read_matrix_text(f, &tsv, 0, &m), 2);
+  rewind(f);
+  ck_assert_int_eq(s21_read_matrix_text(f, NULL, 0, &m), 0);
+  ck_assert_int_eq(m.columns, 3);
+  s21_remove_matrix(&m);
+  fclose(f);
+}
+END_TEST
+
+START_TEST(expr_elementwise) {
+  matrix_t a, b, d, t, tmp1, tmp2, ref, got;
+  s21_expr_t e;
+  s21_create_matrix(37, 29, &a);
+  s21_create_matrix(37, 29, &b);
+  s21_create_matrix(37, 29, &d);
+  fill_random(&a, 1);
+  fill_random(&b, 2);
+  fill_random(&d, 3);
+
+  // (A + B) * 1.5 - D
+  s21_expr_init(&e);
+  int na = s21_expr_matrix(&e, &a), nb = s21_expr_matrix(&e, &b), nd = s21_expr_matrix(&e, &d);
+  int root = s21_expr_sub(&e, s21_expr_scale(&e, s21_expr_sum(&e, na, nb), 1.5), nd);
+  ck_assert_int_eq(s21_eval(&e, root, &got), 0);
+  s21_sum_matrix(&a, &b, &tmp1);
+  s21_mult_number(&tmp1, 1.5, &tmp2);
+  s21_sub_matrix(&tmp2, &d, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&tmp2);
+
+  // Общее подвыражение X = A + B: X + 2X - 3A = 3B, транспонированный лист через шаги.
+  int x = s21_expr_sum(&e, na, nb);
+  root = s21_expr_sub(&e, s21_expr_sum(&e, x, s21_expr_scale(&e, x, 2)), s21_expr_scale(&e, na, 3));
+  ck_assert_int_eq(s21_eval(&e, root, &got), 0);
+  s21_mult_number(&b, 3, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ref);
+  s21_transpose_lazy(&tmp1, &t);
+  s21_transpose(&tmp1, &ref);
+  s21_expr_init(&e);
+  ck_assert_int_eq(s21_eval(&e, s21_expr_matrix(&e, &t), &got), 0);
+  ck_assert_int_eq(matrix_is_transposed(&got), 0);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+
+  // Разные размеры - 2, ошибка построения доходит до корня - 1.
+  root = s21_expr_sum(&e, s21_expr_matrix(&e, &t), s21_expr_matrix(&e, &a));
+  ck_assert_int_eq(s21_eval(&e, root, &got), 2);
+  ck_assert_ptr_null(got.matrix);
+  root = s21_expr_sum(&e, s21_expr_matrix(&e, &got), s21_expr_matrix(&e, &a));
+  ck_assert_int_eq(root, -1);
+  ck_assert_int_eq(s21_eval(&e, root, &got), 1);
+  s21_expr_init(&e);
+  for (int k = 0; k < S21_EXPR_NODES; k++)
+    ck_assert_int_eq(s21_expr_matrix(&e, &a), k);
+  ck_assert_int_eq(s21_expr_matrix(&e, &a), -1);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&t);
+  s21_remove_matrix(&tmp1);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&d);
+}
+END_TEST
+
+START_TEST(expr_mult_add) {
+  matrix_t a, b, c, d, ab, tmp, ref, got;
+  s21_expr_t e;
+  s21_create_matrix(20, 30, &a);
+  s21_create_matrix(30, 25, &b);
+  s21_create_matrix(25, 20, &c);
+  s21_create_matrix(20, 25, &d);
+  fill_random(&a, 4);
+  fill_random(&b, 5);
+  fill_random(&c, 6);
+  fill_random(&d, 7);
+
+  // D - 2 * (A * B): произведение прибавляется к D через gemm с alpha = -2.
+  s21_expr_init(&e);
+  int na = s21_expr_matrix(&e, &a), nb = s21_expr_matrix(&e, &b);
+  int nab = s21_expr_mult(&e, na, nb);
+  int root = s21_expr_sub(&e, s21_expr_matrix(&e, &d), s21_expr_scale(&e, nab, 2));
+  ck_assert_int_eq(s21_eval(&e, root, &got), 0);
+  s21_mult_matrix(&a, &b, &ab);
+  s21_mult_number(&ab, 2, &tmp);
+  s21_sub_matrix(&d, &tmp, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&tmp);
+
+  // Вложенные произведения: (A * B + D) * C, операнд-выражение вычисляется отдельно.
+  root = s21_expr_mult(&e, s21_expr_sum(&e, nab, s21_expr_matrix(&e, &d)), s21_expr_matrix(&e, &c));
+  ck_assert_int_eq(s21_eval(&e, root, &got), 0);
+  s21_sum_matrix(&ab, &d, &tmp);
+  s21_mult_matrix(&tmp, &c, &ref);
+  ck_assert_int_eq(s21_eq_matrix(&got, &ref), SUCCESS);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&tmp);
+  ck_assert_int_eq(s21_eval(&e, s21_expr_mult(&e, na, na), &got), 2);
+
+  // A * B - A * B сокращается до нуля без умножений.
+  root = s21_expr_sub(&e, nab, nab);
+  ck_assert_int_eq(s21_eval(&e, root, &got), 0);
+  for (int y = 0; y < 20; y++)
+    for (int x = 0; x < 25; x++)
+      ck_assert(got.matrix[y][x] == 0);
+  s21_remove_matrix(&got);
+  s21_remove_matrix(&ab);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&c);
+  s21_remove_matrix(&d);
+}
+END_TEST
+
+START_TEST(float_matrix) {
+  matrix_t a, b, ref, back;
+  matrixf_t af, bf, rf, tf;
+  s21_create_matrix(19, 23, &a);
+  s21_create_matrix(23, 17, &b);
+  fill_random(&a, 8);
+  fill_random(&b, 9);
+  ck_assert_int_eq(s21_matrix_to_float(&a, &af), 0);
+  ck_assert_int_eq(s21_matrix_to_float(&b, &bf), 0);
+  ck_assert_int_eq((uintptr_t)af.matrix[0] % MATRIX_ALIGN, 0);
+
+  // Произведение во float совпадает с double до точности float.
+  ck_assert_int_eq(s21_mult_matrixf(&af, &bf, &rf), 0);
+  s21_mult_matrix(&a, &b, &ref);
+  ck_assert_int_eq(s21_matrix_from_float(&rf, &back), 0);
+  for (int y = 0; y < 19; y++)
+    for (int x = 0; x < 17; x++)
+      ck_assert_double_eq_tol(back.matrix[y][x], ref.matrix[y][x], 1e-3);
+  s21_remove_matrix(&back);
+  s21_remove_matrixf(&rf);
+  ck_assert_int_eq(s21_mult_matrixf(&af, &af, &rf), 2);
+  ck_assert_ptr_null(rf.matrix);
+
+  ck_assert_int_eq(s21_transposef(&bf, &tf), 0);
+  ck_assert_int_eq(s21_sum_matrixf(&af, &tf, &rf), 2);
+  s21_remove_matrixf(&tf);
+  ck_assert_int_eq(s21_mult_numberf(&af, 2, &tf), 0);
+  ck_assert_int_eq(s21_sub_matrixf(&tf, &af, &rf), 0);
+  ck_assert_int_eq(s21_eq_matrixf(&rf, &af), SUCCESS);
+  s21_remove_matrixf(&rf);
+  ck_assert_int_eq(s21_sum_matrixf(&af, &af, &rf), 0);
+  ck_assert_int_eq(s21_eq_matrixf(&rf, &tf), SUCCESS);
+  ck_assert_int_eq(s21_eq_matrixf(&rf, &af), FAILURE);
+  s21_remove_matrixf(&rf);
+  s21_remove_matrixf(&tf);
+
+  // Определитель и обратная через float LU.
+  float det;
+  s21_remove_matrix(&a);
+  s21_create_matrix(3, 3, &a);
+  double v[9] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  memcpy(a.matrix[0], v, sizeof(v));
+  s21_remove_matrixf(&af);
+  s21_matrix_to_float(&a, &af);
+  ck_assert_int_eq(s21_determinantf(&af, &det), 0);
+  ck_assert_float_eq_tol(det, -1, 1e-5);
+  ck_assert_int_eq(s21_inverse_matrixf(&af, &rf), 0);
+  ck_assert_float_eq_tol(rf.matrix[0][0], 1, 1e-4);
+  ck_assert_float_eq_tol(rf.matrix[2][1], -29, 1e-3);
+  s21_remove_matrixf(&rf);
+  ck_assert_int_eq(s21_determinantf(&bf, &det), 2);
+
+  // Ведущий элемент порядка ошибки округления float: вырождена, как и в double.
+  s21_remove_matrixf(&af);
+  s21_create_matrixf(2, 2, &af);
+  af.matrix[0][0] = 1;
+  af.matrix[0][1] = 2;
+  af.matrix[1][0] = 2;
+  af.matrix[1][1] = 4.000001f;
+  ck_assert_int_eq(s21_inverse_matrixf(&af, &rf), 2);
+  ck_assert_ptr_null(rf.matrix);
+  s21_remove_matrixf(&af);
+  s21_remove_matrixf(&bf);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(float_lu) {
+  // LU, дополнения и операции на месте во float сверяются с double.
+  matrix_t a, b, x, ref, back;
+  matrixf_t af, bf, xf, cf;
+  s21_luf_t lu;
+  float det = 0;
+  double ref_det = 0;
+  s21_create_matrix(150, 150, &a);
+  s21_create_matrix(150, 7, &b);
+  fill_random(&a, 21);
+  fill_random(&b, 22);
+  for (int i = 0; i < 150; i++)
+    a.matrix[i][i] += 150;
+  s21_matrix_to_float(&a, &af);
+  s21_matrix_to_float(&b, &bf);
+
+  // 150 строк - несколько блоков LU_SOLVE_NB.
+  ck_assert_int_eq(s21_lu_factorf(&af, &lu), 0);
+  ck_assert_int_eq(s21_lu_singularf(&lu), 0);
+  ck_assert_int_eq(s21_lu_solvef(&lu, &bf, &xf), 0);
+  s21_matrix_from_float(&xf, &x);
+  s21_mult_matrix(&a, &x, &ref);
+  for (int y = 0; y < 150; y++)
+    for (int k = 0; k < 7; k++)
+      ck_assert_double_eq_tol(ref.matrix[y][k], b.matrix[y][k], 1e-3);
+  s21_remove_matrix(&ref);
+  s21_remove_matrix(&x);
+  s21_remove_matrixf(&xf);
+  ck_assert_int_eq(s21_lu_inversef(&lu, &xf), 0);
+  s21_remove_matrixf(&xf);
+  s21_lu_freef(&lu);
+  ck_assert_ptr_null(lu.pivots);
+
+  // Операции на месте.
+  ck_assert_int_eq(s21_mult_numberf(&bf, 3, &xf), 0);
+  ck_assert_int_eq(s21_sub_matrix_inplacef(&xf, &bf), 0);
+  ck_assert_int_eq(s21_axpyf(-2, &bf, &xf), 0);
+  ck_assert_int_eq(s21_sum_matrix_inplacef(&xf, &bf), 0);
+  ck_assert_int_eq(s21_mult_number_inplacef(&xf, 2), 0);
+  ck_assert_int_eq(s21_eq_matrixf(&xf, &bf), FAILURE);
+  ck_assert_int_eq(s21_mult_number_inplacef(&xf, 0.5f), 0);
+  for (int y = 0; y < 150; y++)
+    for (int k = 0; k < 7; k++)
+      ck_assert_float_eq_tol(xf.matrix[y][k], bf.matrix[y][k], 1e-5);
+  ck_assert_int_eq(s21_axpyf(1, &af, &xf), 2);
+  s21_remove_matrixf(&xf);
+
+  // Дополнения 4 x 4 - как у double, в том числе у вырожденной матрицы и у 1 x 1.
+  for (int singular = 0; singular < 2; singular++) {
+    matrix_t s;
+    s21_create_matrix(4, 4, &s);
+    fill_random(&s, 23);
+    for (int k = 0; k < 4 && singular; k++)
+      s.matrix[3][k] = s.matrix[0][k] + s.matrix[1][k];
+    s21_remove_matrixf(&af);
+    s21_matrix_to_float(&s, &af);
+    ck_assert_int_eq(s21_calc_complementsf(&af, &cf), 0);
+    s21_calc_complements(&s, &ref);
+    s21_matrix_from_float(&cf, &back);
+    for (int y = 0; y < 4; y++)
+      for (int k = 0; k < 4; k++)
+        ck_assert_double_eq_tol(back.matrix[y][k], ref.matrix[y][k], 1e-2 + 1e-5 * fabs(ref.matrix[y][k]));
+    ck_assert_int_eq(s21_determinantf(&af, &det), 0);
+    s21_determinant(&s, &ref_det);
+    ck_assert_double_eq_tol(det, ref_det, 5e-2 + 1e-5 * fabs(ref_det));
+    s21_remove_matrix(&back);
+    s21_remove_matrix(&ref);
+    s21_remove_matrixf(&cf);
+    s21_remove_matrix(&s);
+  }
+  s21_remove_matrixf(&af);
+  s21_create_matrixf(1, 1, &af);
+  af.matrix[0][0] = 5;
+  ck_assert_int_eq(s21_calc_complementsf(&af, &cf), 0);
+  ck_assert_float_eq_tol(cf.matrix[0][0], 1, 1e-6);
+  s21_remove_matrixf(&cf);
+  s21_remove_matrixf(&af);
+  ck_assert_int_eq(s21_calc_complementsf(&bf, &cf), 2);
+
+  s21_remove_matrixf(&bf);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(solve_mixed) {
+  matrix_t a, b, x, ref;
+  s21_lu_t lu;
+  int it;
+  int n = 120;
+  s21_create_matrix(n, n, &a);
+  s21_create_matrix(n, 3, &b);
+  fill_random(&a, 10);
+  fill_random(&b, 11);
+  for (int k = 0; k < n; k++)
+    a.matrix[k][k] += 200;
+
+  // Хорошо обусловленная система: несколько шагов уточнения дают точность double.
+  ck_assert_int_eq(s21_solve_mixed(&a, &b, &x, &it), 0);
+  ck_assert_int_gt(it, 0);
+  ck_assert_int_le(it, 5);
+  s21_lu_factor(&a, &lu);
+  s21_lu_solve(&lu, &b, &ref);
+  for (int y = 0; y < n; y++)
+    for (int k = 0; k < 3; k++)
+      ck_assert_double_eq_tol(x.matrix[y][k], ref.matrix[y][k], 1e-13);
+  s21_remove_matrix(&x);
+  s21_remove_matrix(&ref);
+  s21_lu_free(&lu);
+
+  // Элементы за пределами float: разложение во float невозможно, решение считается в double.
+  matrix_t h, hb, hx;
+  s21_create_matrix(10, 10, &h);
+  s21_create_matrix(10, 1, &hb);
+  for (int y = 0; y < 10; y++) {
+    for (int k = 0; k < 10; k++) {
+      h.matrix[y][k] = (y == k ? 20.0 : 1.0 / (y + k + 1)) * 1e40;
+      hb.matrix[y][0] += h.matrix[y][k];
+    }
+  }
+  ck_assert_int_eq(s21_solve_mixed(&h, &hb, &hx, &it), 0);
+  ck_assert_int_eq(it, -1);
+  for (int y = 0; y < 10; y++)
+    ck_assert_double_eq_tol(hx.matrix[y][0], 1, 1e-12);
+  s21_remove_matrix(&hx);
+
+  fill(&h, 1);
+  ck_assert_int_eq(s21_solve_mixed(&h, &hb, &hx, NULL), 2);
+  ck_assert_ptr_null(hx.matrix);
+  ck_assert_int_eq(s21_solve_mixed(&a, &hb, &hx, NULL), 2);
+  s21_remove_matrix(&h);
+  s21_remove_matrix(&hb);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(eq_matrix_tol) {
+  // Все уровни SIMD; 100 x 50 - больше одного куска memcmp, отличие кладётся во второй кусок.
+  for (int level = S21_SIMD_SCALAR; level <= s21_simd_supported(); level++) {
+    matrix_t a, b, t;
+    s21_set_simd_level(level);
+    s21_create_matrix(100, 50, &a);
+    fill_random(&a, level + 1);
+    for (int i = 0; i < 5000; i++)
+      a.matrix[0][i] = (a.matrix[0][i] + 11) * 1e12;
+    s21_transpose(&a, &t);
+    s21_transpose_inplace(&t);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &a, S21_EQ_ULP, 0), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &t, S21_EQ_ULP, 0), SUCCESS);
+    s21_create_matrix(100, 50, &b);
+    for (int i = 0; i < 5000; i++)
+      b.matrix[0][i] = nextafter(nextafter(a.matrix[0][i], INFINITY), INFINITY);
+    ck_assert_int_eq(s21_eq_matrix(&a, &b), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, 2), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, 1.5), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, 1e-15), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, 1e-17), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ABS, 1), SUCCESS);
+    memcpy(b.matrix[0], a.matrix[0], 5000 * sizeof(double));
+    b.matrix[99][49] = -b.matrix[99][49];
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, 1), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, S21_EQ_MAX_ULP * 4), FAILURE);
+    a.matrix[99][49] = b.matrix[99][49] = NAN;
+    a.matrix[0][1] = b.matrix[0][1] = INFINITY;
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, 0), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, 0), SUCCESS);
+    b.matrix[0][1] = DBL_MAX;
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, 1), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, 1), SUCCESS);
+    b.matrix[0][1] = -0.0;
+    a.matrix[0][1] = 0.0;
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, 0), SUCCESS);
+    b.matrix[99][49] = 0;
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ULP, S21_EQ_MAX_ULP), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ABS, DBL_MAX), FAILURE);
+    b.matrix[99][49] = -a.matrix[99][49];
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_ABS, 0), SUCCESS);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, 3, 1), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &b, S21_EQ_REL, -1), FAILURE);
+    ck_assert_int_eq(s21_eq_matrix_tol(&a, &t, S21_EQ_ABS, NAN), FAILURE);
+    s21_remove_matrix(&a);
+    s21_remove_matrix(&b);
+    s21_remove_matrix(&t);
+  }
+  s21_set_simd_level(-1);
+}
+END_TEST
+
+START_TEST(matrix_hash) {
+  // Хеш не зависит от уровня SIMD и ориентации хранения, но зависит от размеров и порядка.
+  matrix_t a, b, t;
+  s21_create_matrix(7, 9, &a);
+  fill_random(&a, 3);
+  s21_create_matrix(9, 7, &b);
+  memcpy(b.matrix[0], a.matrix[0], 63 * sizeof(double));
+  s21_transpose(&a, &t);
+  s21_transpose_inplace(&t);
+  s21_set_simd_level(S21_SIMD_SCALAR);
+  uint64_t hash = s21_matrix_hash(&a);
+  for (int level = S21_SIMD_SCALAR; level <= s21_simd_supported(); level++) {
+    s21_set_simd_level(level);
+    ck_assert_uint_eq(s21_matrix_hash(&a), hash);
+    ck_assert_uint_eq(s21_matrix_hash(&t), hash);
+    ck_assert_uint_ne(s21_matrix_hash(&b), hash);
+  }
+  s21_set_simd_level(-1);
+  double first = a.matrix[0][0];
+  a.matrix[0][0] = a.matrix[1][0];
+  a.matrix[1][0] = first;
+  ck_assert_uint_ne(s21_matrix_hash(&a), hash);
+  s21_remove_matrix(&b);
+  ck_assert_uint_eq(s21_matrix_hash(&b), 0);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&t);
+}
+END_TEST
+
+START_TEST(result_cache) {
+  matrix_t a, inv, again, t, small, r;
+  s21_cache_stats_t stats;
+  double det = 0, cached = 0;
+  s21_create_matrix(10, 10, &a);
+  fill_random(&a, 7);
+  for (int i = 0; i < 10; i++)
+    a.matrix[i][i] += 50;
+
+  // По умолчанию кэш выключен.
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), 0);
+  s21_remove_matrix(&inv);
+  s21_cache_snapshot(&stats);
+  ck_assert_uint_eq(stats.hits + stats.misses, 0);
+
+  s21_set_cache_limit(1 << 20);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &inv), 0);
+  ck_assert_int_eq(s21_inverse_matrix(&a, &again), 0);
+  ck_assert_int_eq(memcmp(inv.matrix[0], again.matrix[0], 100 * sizeof(double)), 0);
+  s21_remove_matrix(&again);
+  ck_assert_int_eq(s21_determinant(&a, &det), 0);
+  ck_assert_int_eq(s21_determinant(&a, &cached), 0);
+  ck_assert_double_eq(det, cached);
+  s21_transpose(&a, &t);
+  s21_transpose_inplace(&t);
+  ck_assert_int_eq(s21_inverse_matrix(&t, &again), 0);
+  ck_assert_int_eq(memcmp(inv.matrix[0], again.matrix[0], 100 * sizeof(double)), 0);
+  s21_remove_matrix(&again);
+  s21_cache_snapshot(&stats);
+  ck_assert_uint_eq(stats.hits, 3);
+  ck_assert_uint_eq(stats.misses, 2);
+  ck_assert_int_eq(stats.entries, 2);
+  ck_assert_uint_eq(stats.bytes, 300 * sizeof(double));
+
+  // Изменённый вход - промах; 4x4 в кэш не попадает.
+  a.matrix[9][9] += 1;
+  ck_assert_int_eq(s21_determinant(&a, &cached), 0);
+  ck_assert_double_ne(det, cached);
+  s21_create_matrix(4, 4, &small);
+  fill_random(&small, 1);
+  ck_assert_int_eq(s21_inverse_matrix(&small, &r), 0);
+  s21_remove_matrix(&r);
+  s21_cache_snapshot(&stats);
+  ck_assert_uint_eq(stats.misses, 3);
+  ck_assert_int_eq(stats.entries, 3);
+
+  // Лимит меньше двух записей вытесняет давно не использованные; 0 очищает кэш.
+  s21_set_cache_limit(250 * sizeof(double));
+  s21_cache_snapshot(&stats);
+  ck_assert_int_eq(stats.entries, 1);
+  ck_assert_uint_eq(stats.evictions, 2);
+  ck_assert_int_eq(s21_determinant(&a, &cached), 0);
+  s21_cache_snapshot(&stats);
+  ck_assert_uint_eq(stats.hits, 4);
+  s21_set_cache_limit(0);
+  s21_cache_snapshot(&stats);
+  ck_assert_int_eq(stats.entries, 0);
+  ck_assert_uint_eq(stats.bytes, 0);
+  s21_cache_clear();
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&t);
+  s21_remove_matrix(&inv);
+  s21_remove_matrix(&small);
+}
+END_TEST
+
 int main(void) {
     Suite *s1 = suite_create("Matrix");
     TCase *tc1 = tcase_create("Matrix");
@@ -1168,6 +2910,9 @@ int main(void) {
 
     suite_add_tcase(s1, tc1);
     tcase_add_test(tc1, create_matrix);
+    tcase_add_test(tc1, create_matrix_contiguous);
+    tcase_add_test(tc1, arena_matrices);
+    tcase_add_test(tc1, pool_matrices);
     tcase_add_test(tc1, remove_matrix);
     tcase_add_test(tc1, eq_matrix);
     tcase_add_test(tc1, sum_matrix);
@@ -1210,19 +2955,55 @@ int main(void) {
     tcase_add_test(tc1_1, mult_matrix_5);
     tcase_add_test(tc1_1, mult_matrix_6);
     tcase_add_test(tc1_1, mult_matrix_7);
+    tcase_add_test(tc1_1, mult_matrix_blocked);
+    tcase_add_test(tc1_1, mult_matrix_threads);
+    tcase_add_test(tc1_1, mult_matrix_strassen);
+    tcase_add_test(tc1_1, simd_dispatch_levels);
+    tcase_add_test(tc1_1, inplace_arithmetic);
+    tcase_add_test(tc1_1, gemm_alpha_beta);
     tcase_add_test(tc1_1, transpose_1);
     tcase_add_test(tc1_1, transpose_2);
     tcase_add_test(tc1_1, transpose_3);
+    tcase_add_test(tc1_1, transpose_tiled);
+    tcase_add_test(tc1_1, transpose_inplace);
+    tcase_add_test(tc1_1, transpose_lazy);
+    tcase_add_test(tc1_1, batch_small_matrices);
+    tcase_add_test(tc1_1, batch_shapes);
+    tcase_add_test(tc1_1, fixed_size_kernels);
+    tcase_add_test(tc1_1, fixed_size_types);
+    tcase_add_test(tc1_1, stats_counters);
+    tcase_add_test(tc1_1, sparse_formats);
+    tcase_add_test(tc1_1, sparse_products);
+    tcase_add_test(tc1_1, file_save_load);
+    tcase_add_test(tc1_1, file_mmap);
+    tcase_add_test(tc1_1, text_round_trip);
+    tcase_add_test(tc1_1, text_parse);
+    tcase_add_test(tc1_1, expr_elementwise);
+    tcase_add_test(tc1_1, expr_mult_add);
+    tcase_add_test(tc1_1, float_matrix);
+    tcase_add_test(tc1_1, float_lu);
+    tcase_add_test(tc1_1, solve_mixed);
+    tcase_add_test(tc1_1, eq_matrix_tol);
+    tcase_add_test(tc1_1, matrix_hash);
+    tcase_add_test(tc1_1, result_cache);
     tcase_add_test(tc1_1, determinant_1);
     tcase_add_test(tc1_1, determinant_2);
     tcase_add_test(tc1_1, determinant_3);
     tcase_add_test(tc1_1, determinant_4);
     tcase_add_test(tc1_1, determinant_5);
     tcase_add_test(tc1_1, determinant_6);
+    tcase_add_test(tc1_1, determinant_lu_regression);
+    tcase_add_test(tc1_1, determinant_lu_singular);
+    tcase_add_test(tc1_1, determinant_lu_large);
+    tcase_add_test(tc1_1, submatrix_view);
+    tcase_add_test(tc1_1, minor_view);
     tcase_add_test(tc1_1, calc_complements_1);
     tcase_add_test(tc1_1, calc_complements_2);
     tcase_add_test(tc1_1, calc_complements_3);
     tcase_add_test(tc1_1, calc_complements_4);
+    tcase_add_test(tc1_1, calc_complements_5);
+    tcase_add_test(tc1_1, calc_complements_lu);
+    tcase_add_test(tc1_1, calc_complements_lu_large);
     tcase_add_test(tc1_1, inverse_matrix_1);
     tcase_add_test(tc1_1, inverse_matrix_2);
     tcase_add_test(tc1_1, inverse_matrix_3);
@@ -1230,6 +3011,10 @@ int main(void) {
     tcase_add_test(tc1_1, inverse_matrix_5);
     tcase_add_test(tc1_1, inverse_matrix_6);
     tcase_add_test(tc1_1, inverse_matrix_7);
+    tcase_add_test(tc1_1, inverse_matrix_gauss_jordan);
+    tcase_add_test(tc1_1, inverse_matrix_singular_scaled);
+    tcase_add_test(tc1_1, lu_factor_solve);
+    tcase_add_test(tc1_1, lu_det_singular);
 
     srunner_run_all(sr, CK_ENV);
     nf = srunner_ntests_failed(sr);
@@ -1247,3 +3032,39 @@ void fill(matrix_t *m, double c) {
       count += c;
     }
 }
+
+void fill_random(matrix_t *m, unsigned seed) {
+  unsigned state = seed * 2654435761u + 1;
+
+  for (int i = 0; i < m -> rows; i++)
+    for (int j = 0; j < m -> columns; j++) {
+      state = state * 1103515245u + 12345u;
+      m -> matrix[i][j] = (double)((state >> 16) % 2001) / 100.0 - 10.0;
+    }
+}
+
+double ref_determinant(matrix_t *A) {
+  double det = 0;
+
+  if (A -> rows == 1) {
+    det = A -> matrix[0][0];
+  } else {
+    for (int x = 0; x < A -> columns; x++) {
+      matrix_t M;
+      get_minor(A, &M, 0, x);
+      det += (x % 2 ? -1 : 1) * A -> matrix[0][x] * ref_determinant(&M);
+      s21_remove_matrix(&M);
+    }
+  }
+
+  return det;
+}
+
+void ref_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+  s21_create_matrix(A -> rows, B -> columns, result);
+
+  for (int y = 0; y < A -> rows; y++)
+    for (int x = 0; x < B -> columns; x++)
+      for (int n = 0; n < A -> columns; n++)
+        result -> matrix[y][x] += A -> matrix[y][n] * B -> matrix[n][x];
+}